@@ -0,0 +1,20 @@
+######################################################################
+# Pruebas de rendimiento del parser
+######################################################################
+
+TEMPLATE = app
+TARGET = benchmark
+CONFIG += console
+CONFIG -= app_bundle
+OBJECTS_DIR = build
+DESTDIR = bin
+
+include("../genericParser.pri")
+
+INCLUDEPATH += $$PWD
+
+HEADERS += corpusgenerator.h
+
+SOURCES += \
+    corpusgenerator.cpp \
+    main.cpp
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <QFile>
+#include <QTextStream>
+
+#include <corpusgenerator.h>
+
+CorpusGenerator::CorpusGenerator() {
+    this->depth = 2;
+    this->fanout = 4;
+    this->listLength = 8;
+    this->dictionarySize = 1000;
+    this->state = Q_UINT64_C(0x9E3779B97F4A7C15);
+}
+
+quint32 CorpusGenerator::next() {
+
+    /* Generador xorshift64*, suficiente para producir datos reproducibles.*/
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return quint32((state * Q_UINT64_C(2685821657736338717)) >> 32);
+}
+
+QString CorpusGenerator::word(int index) {
+    return QString("w%1").arg(index);
+}
+
+void CorpusGenerator::setDepth(int depth) {
+    this->depth = qMax(0, depth);
+}
+
+void CorpusGenerator::setFanout(int fanout) {
+    this->fanout = qMax(1, fanout);
+}
+
+void CorpusGenerator::setListLength(int length) {
+    this->listLength = qMax(1, length);
+}
+
+void CorpusGenerator::setDictionarySize(int size) {
+    this->dictionarySize = qMax(1, size);
+}
+
+bool CorpusGenerator::writeGrammar(const QDir &dir) {
+    QFile file(dir.absoluteFilePath(QString(BENCH_FORMAT) + ".xml"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QTextStream out(&file);
+    out.setCodec("UTF-8");
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out << "<parser name=\"" << BENCH_FORMAT << "\">\n";
+
+    /* La producción inicial reconoce una línea y los niveles anidados la
+    vuelven a reconocer hasta llegar a la lista de elementos.*/
+    QString first = depth > 0 ? "level1" : "items";
+    out << "    <" << BENCH_FORMAT << " class=\"initial\" regexp=\"[^\\n]+\\n\">\n";
+    out << "        <" << first << " class=\"reference\" />\n";
+    out << "    </" << BENCH_FORMAT << ">\n";
+
+    for (int level = 1; level <= depth; ++level) {
+        QString child = level < depth ? QString("level%1").arg(level + 1) :
+                                        QString("items");
+        out << "    <level" << level
+            << " class=\"non_terminal\" regexp=\"[^\\n]+\\n\">\n";
+        out << "        <" << child << " class=\"reference\" name=\"var"
+            << level << "\" />\n";
+        out << "    </level" << level << ">\n";
+    }
+
+    out << "    <items class=\"list\">\n";
+    out << "        <item class=\"reference\" />\n";
+    out << "    </items>\n";
+
+    /* Cada elemento es una opción entre los terminales por expresión regular
+    y el diccionario.*/
+    out << "    <item class=\"option\">\n";
+    for (int i = 0; i < fanout; ++i) {
+        out << "        <field" << i << " class=\"reference\" />\n";
+    }
+    out << "        <" << BENCH_DICTIONARY << " class=\"reference\" />\n";
+    out << "    </item>\n";
+
+    for (int i = 0; i < fanout; ++i) {
+        out << "    <field" << i << " class=\"reg_terminal\" regexp=\"f" << i
+            << "_[0-9]+\\b\" />\n";
+    }
+    out << "    <" << BENCH_DICTIONARY << " class=\"dic_terminal\" />\n";
+    out << "</parser>\n";
+
+    out.flush();
+    return file.error() == QFile::NoError;
+}
+
+bool CorpusGenerator::writeDictionary(const QDir &dir) {
+    QFile file(dir.absoluteFilePath(QString(BENCH_DICTIONARY) + ".dic"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QTextStream out(&file);
+    for (int i = 0; i < dictionarySize; ++i) {
+        out << word(i) << '\n';
+    }
+
+    out.flush();
+    return file.error() == QFile::NoError;
+}
+
+qint64 CorpusGenerator::writeInput(QIODevice *device, qint64 bytes) {
+    qint64 written = 0;
+    qint64 records = 0;
+    QByteArray line;
+
+    /* Cada registro es una línea con listLength elementos separados por
+    espacios, elegidos entre los terminales y las palabras del diccionario.*/
+    while (written < bytes) {
+        line.clear();
+        for (int i = 0; i < listLength; ++i) {
+            if (i > 0) {
+                line.append(' ');
+            }
+            quint32 choice = next() % quint32(fanout + 1);
+            if (choice == quint32(fanout)) {
+                line.append(word(next() % quint32(dictionarySize)).toLatin1());
+            } else {
+                line.append('f');
+                line.append(QByteArray::number(choice));
+                line.append('_');
+                line.append(QByteArray::number(next() % 100000));
+            }
+        }
+        line.append('\n');
+
+        if (device->write(line) != line.size()) {
+            break;
+        }
+        written += line.size();
+        records++;
+    }
+    return records;
+}
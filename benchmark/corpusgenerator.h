@@ -0,0 +1,87 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef CORPUSGENERATOR_H
+#define CORPUSGENERATOR_H
+
+#include <QDir>
+#include <QIODevice>
+#include <QString>
+
+#define BENCH_FORMAT "bench"
+#define BENCH_DICTIONARY "words"
+
+/**
+* CorpusGenerator genera una gramática, un diccionario y una entrada de texto
+* sintéticos para medir el rendimiento del parser.
+*
+* Cada registro de la entrada es una línea. La gramática anida depth
+* producciones no terminales sobre la línea y en el último nivel reconoce una
+* lista de elementos; cada elemento es una opción entre fanout terminales por
+* expresión regular y el diccionario. Los registros tienen listLength
+* elementos.
+*/
+class CorpusGenerator
+{
+    private:
+
+        /** Cantidad de niveles no terminales anidados. */
+        int depth;
+
+        /** Cantidad de alternativas por expresión regular de cada elemento. */
+        int fanout;
+
+        /** Cantidad de elementos de cada registro. */
+        int listLength;
+
+        /** Cantidad de palabras del diccionario. */
+        int dictionarySize;
+
+        /** Estado del generador pseudoaleatorio. */
+        quint64 state;
+
+        /** Retorna el siguiente número pseudoaleatorio. */
+        quint32 next();
+
+        /** Retorna la palabra del diccionario de índice index. */
+        static QString word(int index);
+
+    public:
+
+        /** Constructor, utiliza una semilla fija. */
+        CorpusGenerator();
+
+        /** Establece la cantidad de niveles no terminales anidados. */
+        void setDepth(int depth);
+
+        /** Establece la cantidad de alternativas de cada elemento. */
+        void setFanout(int fanout);
+
+        /** Establece la cantidad de elementos de cada registro. */
+        void setListLength(int length);
+
+        /** Establece la cantidad de palabras del diccionario. */
+        void setDictionarySize(int size);
+
+        /**
+        * Escribe la gramática del formato BENCH_FORMAT en el directorio dir.
+        * @return Devuelve false si no se pudo escribir el fichero.
+        */
+        bool writeGrammar(const QDir &dir);
+
+        /**
+        * Escribe el diccionario BENCH_DICTIONARY en el directorio dir.
+        * @return Devuelve false si no se pudo escribir el fichero.
+        */
+        bool writeDictionary(const QDir &dir);
+
+        /**
+        * Escribe en device registros hasta alcanzar al menos bytes bytes.
+        * @return Devuelve la cantidad de registros escritos.
+        */
+        qint64 writeInput(QIODevice *device, qint64 bytes);
+};
+
+#endif // CORPUSGENERATOR_H
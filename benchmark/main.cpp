@@ -0,0 +1,275 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <cstdio>
+
+#include <corpusgenerator.h>
+#include <parsermanager.h>
+#include <parser.h>
+#include <parseresult.h>
+#include <outputsink.h>
+#include <dictionarymanager.h>
+
+/**
+* Destino que solo cuenta las ocurrencias, para medir el análisis sin el costo
+* de la salida.
+*/
+class CountingSink : public OutputSink
+{
+    public:
+
+        /** Cantidad de ocurrencias recibidas. */
+        qint64 count;
+
+        CountingSink() {
+            count = 0;
+        }
+
+        void occurrence(const Occurrence &ocur) {
+            Q_UNUSED(ocur);
+            count++;
+        }
+};
+
+/**
+* Dispositivo que descarta lo que se escribe, para medir la generación de la
+* salida sin el costo de almacenarla.
+*/
+class NullDevice : public QIODevice
+{
+    protected:
+
+        qint64 readData(char *data, qint64 maxSize) {
+            Q_UNUSED(data);
+            Q_UNUSED(maxSize);
+            return -1;
+        }
+
+        qint64 writeData(const char *data, qint64 maxSize) {
+            Q_UNUSED(data);
+            return maxSize;
+        }
+};
+
+/** Interpreta una cantidad con sufijo opcional K, M o G. */
+static qint64 parseSize(QString text) {
+    qint64 factor = 1;
+    text = text.trimmed().toUpper();
+    if (text.endsWith('K')) {
+        factor = Q_INT64_C(1) << 10;
+    } else if (text.endsWith('M')) {
+        factor = Q_INT64_C(1) << 20;
+    } else if (text.endsWith('G')) {
+        factor = Q_INT64_C(1) << 30;
+    }
+    if (factor > 1) {
+        text.chop(1);
+    }
+    return text.toLongLong() * factor;
+}
+
+/** Imprime el resultado de una prueba. */
+static void report(const char *name, qint64 nsecs, qint64 bytes,
+                   qint64 records) {
+    double secs = nsecs / 1e9;
+    double mbs = secs > 0 ? bytes / secs / (1 << 20) : 0;
+    double rps = secs > 0 ? records / secs : 0;
+    std::printf("%-24s %10.3f s %10.2f MB/s %14.0f records/s\n", name, secs,
+                mbs, rps);
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser options;
+    options.setApplicationDescription(
+                "Pruebas de rendimiento del parser con datos sintéticos.");
+    options.addHelpOption();
+    QCommandLineOption sizeOption("size", "Tamaño de la entrada (K, M, G).",
+                                  "bytes", "8M");
+    QCommandLineOption dictOption("dictionary", "Palabras del diccionario.",
+                                  "count", "10000");
+    QCommandLineOption depthOption("depth", "Niveles no terminales anidados.",
+                                   "count", "2");
+    QCommandLineOption fanoutOption("fanout", "Alternativas de cada elemento.",
+                                    "count", "4");
+    QCommandLineOption listOption("list", "Elementos de cada registro.",
+                                  "count", "8");
+    QCommandLineOption workersOption("workers", "Hilos de parseFormat.",
+                                     "count", "1");
+    QCommandLineOption memoryOption("max-memory",
+                                    "Tamaño máximo de entrada que se carga en "
+                                    "memoria (K, M, G).", "bytes", "512M");
+    QCommandLineOption dirOption("dir", "Directorio donde se generan los datos.",
+                                 "path");
+    options.addOption(sizeOption);
+    options.addOption(dictOption);
+    options.addOption(depthOption);
+    options.addOption(fanoutOption);
+    options.addOption(listOption);
+    options.addOption(workersOption);
+    options.addOption(memoryOption);
+    options.addOption(dirOption);
+    options.process(app);
+
+    /* Se generan la gramática, el diccionario y la entrada.*/
+    QTemporaryDir tempDir;
+    QDir dir(options.isSet(dirOption) ? options.value(dirOption) :
+                                        tempDir.path());
+    if (!dir.exists() && !dir.mkpath(".")) {
+        std::fprintf(stderr, "No se pudo crear el directorio de datos\n");
+        return 1;
+    }
+
+    CorpusGenerator generator;
+    generator.setDepth(options.value(depthOption).toInt());
+    generator.setFanout(options.value(fanoutOption).toInt());
+    generator.setListLength(options.value(listOption).toInt());
+    generator.setDictionarySize(options.value(dictOption).toInt());
+
+    QString inputPath = dir.absoluteFilePath("input.txt");
+    QFile inputFile(inputPath);
+    if (!generator.writeGrammar(dir) || !generator.writeDictionary(dir) ||
+            !inputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::fprintf(stderr, "No se pudieron escribir los datos de prueba\n");
+        return 1;
+    }
+    qint64 records = generator.writeInput(&inputFile,
+                                          parseSize(options.value(sizeOption)));
+    qint64 inputBytes = inputFile.size();
+    inputFile.close();
+
+    QFile dictFile(dir.absoluteFilePath(QString(BENCH_DICTIONARY) + ".dic"));
+    qint64 dictBytes = dictFile.size();
+    qint64 dictWords = options.value(dictOption).toLongLong();
+
+    std::printf("input: %lld bytes, %lld records; dictionary: %lld words\n",
+                inputBytes, records, dictWords);
+
+    QElapsedTimer timer;
+
+    /* Carga del diccionario construyendo el autómata y desde su imagen
+    precompilada.*/
+    {
+        DictionaryManager compiled(dir);
+        timer.start();
+        compiled.loadDictionary(BENCH_DICTIONARY);
+        report("dictionary compile", timer.nsecsElapsed(), dictBytes, dictWords);
+
+        compiled.buildSnapshot(BENCH_DICTIONARY);
+        DictionaryManager mapped(dir);
+        mapped.setSnapshotsEnabled(true);
+        timer.start();
+        mapped.loadDictionary(BENCH_DICTIONARY);
+        report("dictionary snapshot", timer.nsecsElapsed(), dictBytes, dictWords);
+    }
+
+    ParserManager manager(dir);
+    manager.setWorkerCount(options.value(workersOption).toInt());
+    int parserPos = manager.findParser(BENCH_FORMAT);
+    if (parserPos == -1) {
+        std::fprintf(stderr, "No se pudo cargar la gramática generada\n");
+        return 1;
+    }
+
+    /* Análisis por flujo, sin cargar la entrada en memoria.*/
+    {
+        CountingSink sink;
+        timer.start();
+        manager.parseFile(inputPath, &sink);
+        report("parseFile", timer.nsecsElapsed(), inputBytes, sink.count);
+    }
+
+    if (inputBytes > parseSize(options.value(memoryOption))) {
+        std::printf("input larger than --max-memory, in-memory benchmarks "
+                    "skipped\n");
+        return 0;
+    }
+
+    inputFile.open(QIODevice::ReadOnly);
+    QString input = QString::fromUtf8(inputFile.readAll());
+    inputFile.close();
+
+    /* Parser::parse sobre cada registro, reutilizando el resultado.*/
+    {
+        QDomDocument config;
+        QFile configFile(dir.absoluteFilePath(QString(BENCH_FORMAT) + ".xml"));
+        configFile.open(QIODevice::ReadOnly);
+        config.setContent(&configFile);
+        DictionaryManager dictionaries(dir);
+        Parser parser(config.documentElement(), &dictionaries);
+        parser.preloadDictionaries();
+
+        QStringList lines;
+        int begin = 0;
+        int end;
+        while ((end = input.indexOf(QLatin1Char('\n'), begin)) != -1) {
+            lines.append(input.mid(begin, end - begin + 1));
+            begin = end + 1;
+        }
+
+        ParseResult result;
+        qint64 parsed = 0;
+        timer.start();
+        for (int i = 0; i < lines.size(); ++i) {
+            if (parser.parse(&lines[i], result)) {
+                parsed++;
+            }
+        }
+        report("Parser::parse", timer.nsecsElapsed(), inputBytes, parsed);
+
+        /* El mismo análisis sin descartar alternativas por sus primeros
+        caracteres, para comparar el costo del descarte.*/
+        parser.setLookaheadEnabled(false);
+        parsed = 0;
+        timer.start();
+        for (int i = 0; i < lines.size(); ++i) {
+            if (parser.parse(&lines[i], result)) {
+                parsed++;
+            }
+        }
+        report("  without lookahead", timer.nsecsElapsed(), inputBytes, parsed);
+    }
+
+    {
+        CountingSink sink;
+        manager.resetStats();
+        timer.start();
+        manager.parseFormat(&input, &sink, parserPos);
+        report("parseFormat", timer.nsecsElapsed(), inputBytes, sink.count);
+
+        /* Distribución del tiempo por ocurrencia del análisis anterior.*/
+        FormatStats stats = manager.formatStats().at(parserPos);
+        std::printf("%-24s p50 %lld ns, p99 %lld ns, p999 %lld ns, "
+                    "max %lld ns\n", "  latency", (long long)stats.p50,
+                    (long long)stats.p99, (long long)stats.p999,
+                    (long long)stats.max);
+        std::fflush(stdout);
+    }
+
+    {
+        CountingSink sink;
+        timer.start();
+        manager.parseAll(&input, &sink);
+        report("parseAll", timer.nsecsElapsed(), inputBytes, sink.count);
+    }
+
+    {
+        NullDevice device;
+        device.open(QIODevice::WriteOnly);
+        timer.start();
+        manager.toXml(&input, &device);
+        report("toXml", timer.nsecsElapsed(), inputBytes, records);
+    }
+
+    return 0;
+}
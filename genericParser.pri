@@ -1,16 +1,65 @@
-QT += xml
+QT += xml concurrent
 
 INCLUDEPATH += $$PWD/src
 DEPENDPATH += $$PWD/src
 
+# Contadores de evaluación por regla (Parser::profileReport).
+# DEFINES += GENERIC_PARSER_PROFILING
+
 HEADERS += \
     $$PWD/src/parser.h \
+    $$PWD/src/grammar.h \
+    $$PWD/src/projection.h \
+    $$PWD/src/symboltable.h \
+    $$PWD/src/matcher.h \
+    $$PWD/src/charset.h \
+    $$PWD/src/parsecontext.h \
+    $$PWD/src/ruleprofiler.h \
+    $$PWD/src/latencyhistogram.h \
     $$PWD/src/dictionarymanager.h \
+    $$PWD/src/dictionarymatcher.h \
     $$PWD/src/astnode.h \
+    $$PWD/src/arena.h \
+    $$PWD/src/parseresult.h \
+    $$PWD/src/batchresult.h \
+    $$PWD/src/outputsink.h \
+    $$PWD/src/domsink.h \
+    $$PWD/src/xmlstreamsink.h \
+    $$PWD/src/jsonsink.h \
+    $$PWD/src/binarysink.h \
+    $$PWD/src/parsevisitor.h \
+    $$PWD/src/visitorsink.h \
+    $$PWD/src/inputreader.h \
+    $$PWD/src/streamreader.h \
+    $$PWD/src/mappedreader.h \
+    $$PWD/src/formatscanner.h \
     $$PWD/src/parsermanager.h
 
 SOURCES += \
     $$PWD/src/parser.cpp \
+    $$PWD/src/grammar.cpp \
+    $$PWD/src/projection.cpp \
+    $$PWD/src/symboltable.cpp \
+    $$PWD/src/matcher.cpp \
+    $$PWD/src/charset.cpp \
+    $$PWD/src/parsecontext.cpp \
+    $$PWD/src/ruleprofiler.cpp \
+    $$PWD/src/latencyhistogram.cpp \
     $$PWD/src/dictionarymanager.cpp \
+    $$PWD/src/dictionarymatcher.cpp \
     $$PWD/src/astnode.cpp \
+    $$PWD/src/arena.cpp \
+    $$PWD/src/parseresult.cpp \
+    $$PWD/src/batchresult.cpp \
+    $$PWD/src/outputsink.cpp \
+    $$PWD/src/domsink.cpp \
+    $$PWD/src/xmlstreamsink.cpp \
+    $$PWD/src/jsonsink.cpp \
+    $$PWD/src/binarysink.cpp \
+    $$PWD/src/parsevisitor.cpp \
+    $$PWD/src/visitorsink.cpp \
+    $$PWD/src/inputreader.cpp \
+    $$PWD/src/streamreader.cpp \
+    $$PWD/src/mappedreader.cpp \
+    $$PWD/src/formatscanner.cpp \
     $$PWD/src/parsermanager.cpp
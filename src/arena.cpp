@@ -0,0 +1,81 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <arena.h>
+
+Arena::Arena(int blockSize) {
+    this->current = 0;
+    this->offset = 0;
+    this->blockSize = blockSize;
+}
+
+Arena::~Arena() {
+    for (int i = 0; i < blocks.size(); ++i) {
+        delete[] blocks.at(i).data;
+    }
+}
+
+void *Arena::allocate(int size) {
+    size = (size + 7) & ~7;
+
+    /* Si la reserva cabe en el bloque actual solo se avanza el
+    desplazamiento.*/
+    if (current < blocks.size() && offset + size <= blocks.at(current).size) {
+        void *result = blocks.at(current).data + offset;
+        offset += size;
+        return result;
+    }
+
+    /* De lo contrario se pasa al siguiente bloque con espacio suficiente,
+    reservando uno nuevo si no existe.*/
+    if (current < blocks.size()) {
+        current++;
+    }
+    while (current < blocks.size() && blocks.at(current).size < size) {
+        current++;
+    }
+    if (current == blocks.size()) {
+        Block block;
+        block.size = qMax(blockSize, size);
+        block.data = new char[block.size];
+        blocks.append(block);
+    }
+
+    offset = size;
+    return blocks.at(current).data;
+}
+
+Arena::Mark Arena::mark() const {
+    Mark m;
+    m.block = current;
+    m.offset = offset;
+    return m;
+}
+
+void Arena::rewind(const Mark &m) {
+    current = m.block;
+    offset = m.offset;
+}
+
+void Arena::clear() {
+    current = 0;
+    offset = 0;
+}
+
+qint64 Arena::bytesUsed() const {
+    qint64 used = offset;
+    for (int i = 0; i < current && i < blocks.size(); ++i) {
+        used += blocks.at(i).size;
+    }
+    return used;
+}
+
+qint64 Arena::capacity() const {
+    qint64 total = 0;
+    for (int i = 0; i < blocks.size(); ++i) {
+        total += blocks.at(i).size;
+    }
+    return total;
+}
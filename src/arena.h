@@ -0,0 +1,91 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <QVector>
+
+#define DEFAULT_ARENA_BLOCK (16 * 1024)
+
+/**
+* Arena es un asignador de memoria por bloques en el que cada reserva solo
+* avanza un desplazamiento. La memoria no se libera por objeto: se puede
+* retroceder hasta una marca anterior, al descartar un análisis parcial, o
+* vaciar por completo conservando los bloques para reutilizarlos. Solo deben
+* crearse en ella objetos cuyo destructor no tenga efecto.
+*/
+class Arena
+{
+    public:
+
+        /** Posición de la arena a la que se puede retroceder. */
+        struct Mark
+        {
+            int block;
+            int offset;
+        };
+
+    private:
+
+        /** Bloque de memoria de la arena. */
+        struct Block
+        {
+            char *data;
+            int size;
+        };
+
+        /** Bloques reservados, en orden de uso. */
+        QVector<Block> blocks;
+
+        /** Índice del bloque en uso. */
+        int current;
+
+        /** Desplazamiento dentro del bloque en uso. */
+        int offset;
+
+        /** Tamaño de los bloques que se reservan. */
+        int blockSize;
+
+        Arena(const Arena &);
+        Arena &operator=(const Arena &);
+
+    public:
+
+        /**
+        * Constructor.
+        * @param blockSize tamaño en bytes de cada bloque de memoria.
+        */
+        Arena(int blockSize = DEFAULT_ARENA_BLOCK);
+
+        /** Destructor, libera todos los bloques. */
+        ~Arena();
+
+        /**
+        * Reserva size bytes alineados a 8 bytes.
+        * @return Devuelve un puntero a la memoria reservada.
+        */
+        void *allocate(int size);
+
+        /** Retorna la posición actual de la arena. */
+        Mark mark() const;
+
+        /**
+        * Descarta todas las reservas posteriores a la marca m.
+        * @param m posición obtenida previamente con mark().
+        */
+        void rewind(const Mark &m);
+
+        /** Descarta todas las reservas conservando los bloques. */
+        void clear();
+
+        /** Retorna la cantidad de bytes reservados en la arena. */
+        qint64 bytesUsed() const;
+
+        /** Retorna la capacidad total de los bloques de la arena. */
+        qint64 capacity() const;
+};
+
+#endif // ARENA_H
@@ -3,48 +3,49 @@
  * @author Isbel Ochoa Izquierdo
  */
 
+#include <new>
+
 #include <astnode.h>
+#include <arena.h>
+#include <symboltable.h>
 
 AstNode::AstNode() {
-    this->tagName = QString();
-    this->name = QString();
+    this->tagName = -1;
+    this->name = -1;
     this->textReference = QStringRef();
+    this->first = NULL;
+    this->last = NULL;
+    this->next = NULL;
+    this->children = 0;
 }
 
-AstNode::AstNode(QString tag, QStringRef txtRef, QString var) {
+AstNode::AstNode(int tag, QStringRef txtRef, int var) {
     this->tagName = tag;
     this->textReference = txtRef;
-    this->name = var.isEmpty() ? tag : var;
-}
-
-AstNode::~AstNode() {
-    clear();
+    this->name = var == -1 ? tag : var;
+    this->first = NULL;
+    this->last = NULL;
+    this->next = NULL;
+    this->children = 0;
 }
 
-void AstNode::clear() {
-    name.clear();
-    textReference.clear();
-    for (int i = 0; i < childList.size(); ++i) {
-        if (childList[i]) {
-            delete childList[i];
-        }
-    }
-    childList.clear();
+AstNode *AstNode::create(Arena &arena, int tag, QStringRef txtRef, int var) {
+    return new (arena.allocate(sizeof(AstNode))) AstNode(tag, txtRef, var);
 }
 
 bool AstNode::isNull() {
     return textReference.isEmpty();
 }
 
-QString AstNode::getTagName() {
+int AstNode::getTagName() {
     return this->tagName;
 }
 
-QString AstNode::getName() {
+int AstNode::getName() {
     return this->name;
 }
 
-void AstNode::setName(QString name) {
+void AstNode::setName(int name) {
     this->name = name;
 }
 
@@ -53,76 +54,109 @@ QStringRef AstNode::getReference() {
 }
 
 int AstNode::childCount() {
-    return childList.size();
+    return children;
+}
+
+AstNode *AstNode::getFirstChild() {
+    return first;
+}
+
+AstNode *AstNode::getNextSibling() {
+    return next;
 }
 
 void AstNode::addChild(AstNode *child) {
 
-    /* Si el puntero es NULL no es agregado a la lista de hijos.*/
-    if (!child) {
+    /* Si el puntero es NULL o el nodo es nulo no es agregado a la lista de
+    hijos.*/
+    if (!child || child->isNull()) {
+        return;
+    }
+
+    child->next = NULL;
+    children++;
+
+    /* Si la lista de elementos hijos está vacía se agrega el nodo.*/
+    if (!first) {
+        first = child;
+        last = child;
         return;
     }
 
-    if (child->isNull()) {
-        delete child;
-        child = NULL;
+    /* Si el nuevo elemento está posicionado después del último elemento de la
+    lista se adiciona al final*/
+    int childPos = child->getReference().position();
+    if (childPos > last->getReference().position()) {
+        last->next = child;
+        last = child;
         return;
     }
 
-    /* Si la lista de elementos hijos está vacía se agrega el puntero.*/
-    if (childList.isEmpty()) {
-        childList.append(child);
+    /* Si el nuevo elemento está posicionado antes del último elemento de la
+    lista se busca la posición donde debe ser insertado, después de los que
+    comienzan en la misma posición o antes.*/
+    if (childPos < first->getReference().position()) {
+        child->next = first;
+        first = child;
         return;
     }
+    AstNode *cursor = first;
+    while (cursor->next &&
+           cursor->next->getReference().position() <= childPos) {
+        cursor = cursor->next;
+    }
+    child->next = cursor->next;
+    cursor->next = child;
+    if (!child->next) {
+        last = child;
+    }
+}
 
-    /* Se obtienen las posiciones del último elemento de la lista y la del
-    elemento que se debe agregar.*/
-    int lastPos = childList.last()->getReference().position();
-    int childPos = child->getReference().position();
+int AstNode::nodeCount() {
+    int count = 1;
+    for (AstNode *child = first; child; child = child->next) {
+        count += child->nodeCount();
+    }
+    return count;
+}
 
-    /* Si el nuevo elemento está posicionado después del último elemento de la
-    lista se adiciona al final*/
-    if (childPos > lastPos) {
-        childList.append(child);
-
-        /* Si el nuevo elemento está posicionado antes del último elemento de la
-    lista se procede a buscar la posición donde debe ser insertado.*/
-    } else {
-        int begin = 0;
-        int end = childList.size() - 1;
-        while (begin < end -1) {
-            /*búsqueda binaria de la posición en la que se va a insertar el
-            nuevo elemento.*/
-            int pivot = (begin + end) / 2;
-            int testPos = childList.at(pivot)->getReference().position();
-            if (childPos > testPos) {
-                begin = pivot;
-            } else {
-                end = pivot;
-            }
+AstNode *AstNode::clone(Arena &arena) {
+    AstNode *copy = create(arena, tagName, textReference, name);
+
+    /* Los hijos ya se encuentran ordenados por posición, por lo que se
+    agregan directamente al final de la lista.*/
+    for (AstNode *child = first; child; child = child->next) {
+        AstNode *childCopy = child->clone(arena);
+        if (copy->last) {
+            copy->last->next = childCopy;
+        } else {
+            copy->first = childCopy;
         }
-        childList.insert(end, child);
+        copy->last = childCopy;
+        copy->children++;
     }
+    return copy;
 }
 
 QString AstNode::toString() {
     return textReference.toString();
 }
 
-QDomElement AstNode::toDom(QDomDocument *xml) {
+QDomElement AstNode::toDom(QDomDocument *xml, const SymbolTable *symbols,
+                           qint64 base) {
 
     /* Se crea el elemento que se va a retornar.*/
-    QDomElement result = xml->createElement(tagName);
+    QDomElement result = xml->createElement(symbols->name(tagName));
 
     /* Se le agregan al elemento los atributos de posición y longitud del texto
     al que hace referencia.*/
-    result.setAttribute(ATTR_POS, textReference.position());
+    result.setAttribute(ATTR_POS, base + textReference.position());
     result.setAttribute(ATTR_LENGTH, textReference.length());
 
     /* Se agrega un atrubuto 'name' si el nombre definido es diferente al nombre
     del tag.*/
     if (name != tagName) {
-        result.setAttribute(ATTR_NAME, name);
+        result.setAttribute(ATTR_NAME, symbols->name(name));
     }
 
     /* Si el nodo no tiene elementos hijos se agrega el texto referenciado.*/
@@ -133,8 +167,8 @@ QDomElement AstNode::toDom(QDomDocument *xml) {
 
     /* Si el nodo tiene elementos hijos se agregan los elementos resultantes de
     procesar cada uno de ellos.*/
-    for (int i = 0; i < childCount(); ++i) {
-        result.appendChild(childList.at(i)->toDom(xml));
+    for (AstNode *child = first; child; child = child->next) {
+        result.appendChild(child->toDom(xml, symbols, base));
     }
 
     return result;
@@ -8,53 +8,75 @@
 
 #include <QString>
 #include <QStringRef>
-#include <QList>
 #include <QDomDocument>
 
 #define ATTR_NAME "name"
 #define ATTR_POS "position"
 #define ATTR_LENGTH "length"
 
+class Arena;
+class SymbolTable;
+
 /**
 * AstNode representa un nodo del árbol que se genera un analizador de texto.
+* Los nodos se crean en la arena de un ParseResult, que es quien los libera, y
+* sus hijos forman una lista enlazada dentro de la propia arena. Las etiquetas
+* y nombres se guardan como identificadores de la tabla de símbolos de la
+* gramática, por lo que el nodo no reserva memoria propia.
 */
 class AstNode
 {
     protected:
 
-        /** Etiqueta de la estructura sintáctica identificada. */
-        QString tagName;
+        /** Identificador de la etiqueta de la estructura identificada. */
+        qint32 tagName;
 
         /**
-        * Nombre que toma la vriable definida para la referencia de texto al
-        * ser identificada en la sintaxis.
+        * Identificador del nombre que toma la vriable definida para la
+        * referencia de texto al ser identificada en la sintaxis.
         */
-        QString name;
+        qint32 name;
 
         /** Referencia al texto en la entrada de texto analizada. */
         QStringRef textReference;
 
-        /** Lista de punteros a los nodos hijos del nodo en cuestión. */
-        QList<AstNode *> childList;
+        /** Primer nodo hijo, ordenados por posición. */
+        AstNode *first;
+
+        /** Último nodo hijo. */
+        AstNode *last;
+
+        /** Siguiente nodo en la lista de hijos del padre. */
+        AstNode *next;
+
+        /** Cantidad de nodos hijos. */
+        int children;
 
     public:
 
-        /** Constructor por defecto. */
+        /** Constructor por defecto, crea un nodo nulo. */
         AstNode();
 
         /**
         * Constructor de inicialización de atributos.
-        * @param tag etiqueta de la estructura identificada.
+        * @param tag identificador de la etiqueta de la estructura.
         * @param txtRef referencia de texto del nodo.
-        * @param var nombre de variable definida para el nodo.
+        * @param var identificador del nombre de variable definido para el
+        * nodo, si es -1 se utiliza la etiqueta.
         */
-        AstNode(QString tag, QStringRef txtRef, QString var = QString());
+        AstNode(int tag, QStringRef txtRef, int var = -1);
 
-        /** Destructor. */
-        ~AstNode();
-
-        /** Elimina todos los hijos de este nodo. */
-        void clear();
+        /**
+        * Crea un nodo en la arena arena.
+        * @param arena arena donde se reserva el nodo.
+        * @param tag identificador de la etiqueta de la estructura.
+        * @param txtRef referencia de texto del nodo.
+        * @param var identificador del nombre de variable definido para el
+        * nodo.
+        * @return Devuelve el nodo creado.
+        */
+        static AstNode *create(Arena &arena, int tag, QStringRef txtRef,
+                               int var = -1);
 
         /**
         * Retorna si el nodo es nulo.
@@ -63,17 +85,18 @@ class AstNode
         */
         bool isNull();
 
-        /** Retorna la etiqueta de sintaxis identificada. */
-        QString getTagName();
+        /** Retorna el identificador de la etiqueta de sintaxis identificada. */
+        int getTagName();
 
-        /** Retorna el nombre la variable indentificada. */
-        QString getName();
+        /** Retorna el identificador del nombre la variable indentificada. */
+        int getName();
 
         /**
         * Establece el nombre de la variable identificada.
-        * @param name valor a establecer en el atributo name de la clase.
+        * @param name identificador a establecer en el atributo name de la
+        * clase.
         */
-        void setName(QString name);
+        void setName(int name);
 
         /** Retorna la referencia al texto de este nodo. */
         QStringRef getReference();
@@ -81,12 +104,32 @@ class AstNode
         /** Retorna la cantidad de nodos hijos de este nodo. */
         int childCount();
 
+        /** Retorna el primer nodo hijo o NULL si no tiene hijos. */
+        AstNode *getFirstChild();
+
+        /** Retorna el siguiente nodo hermano o NULL si es el último. */
+        AstNode *getNextSibling();
+
         /**
-        * Adiciona un nodo a la lista de hijos.
+        * Adiciona un nodo a la lista de hijos, manteniéndola ordenada por la
+        * posición del texto referenciado.
         * @param child puntero al nodo que se agregará como hijo.
         */
         void addChild(AstNode *child);
 
+        /**
+        * Retorna la cantidad de nodos del árbol cuya raíz es este nodo,
+        * incluyéndolo.
+        */
+        int nodeCount();
+
+        /**
+        * Crea una copia del árbol cuya raíz es este nodo.
+        * @param arena arena donde se reservan los nodos de la copia.
+        * @return Devuelve la raíz de la copia.
+        */
+        AstNode *clone(Arena &arena);
+
         /** Obtiene el texto referenciado por textReferece. */
         QString toString();
 
@@ -94,9 +137,12 @@ class AstNode
         * Convierte el árbol en un objeto QDomElement que es agregado al
         * documento xml.
         * @param xml documento al que se agregará la estructura del árbol.
+        * @param symbols tabla de símbolos de la gramática que generó el árbol.
+        * @param base valor que se suma a la posición de cada nodo.
         * @return retorna el objeto QDomDocument que ha sido agregado a xml.
         */
-        QDomElement toDom(QDomDocument *xml);
+        QDomElement toDom(QDomDocument *xml, const SymbolTable *symbols,
+                          qint64 base = 0);
 };
 
 #endif
@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <batchresult.h>
+
+BatchResult::BatchResult() {
+    this->matched = 0;
+    this->symbols = NULL;
+}
+
+int BatchResult::size() const {
+    return roots.size();
+}
+
+int BatchResult::matchedCount() const {
+    return this->matched;
+}
+
+AstNode *BatchResult::root(int index) const {
+    return roots.at(index);
+}
+
+void BatchResult::append(AstNode *root) {
+    roots.append(root);
+    if (root) {
+        matched++;
+    }
+}
+
+void BatchResult::clear(int capacity) {
+
+    /* QVector conserva su capacidad al reducir su tamaño.*/
+    roots.resize(0);
+    roots.reserve(capacity);
+    matched = 0;
+    arena.clear();
+}
+
+Arena &BatchResult::nodeArena() {
+    return this->arena;
+}
+
+const SymbolTable *BatchResult::symbolTable() const {
+    return this->symbols;
+}
+
+void BatchResult::setSymbolTable(const SymbolTable *symbols) {
+    this->symbols = symbols;
+}
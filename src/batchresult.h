@@ -0,0 +1,83 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef BATCHRESULT_H
+#define BATCHRESULT_H
+
+#include <QVector>
+
+#include <arena.h>
+
+class AstNode;
+class SymbolTable;
+
+/**
+* BatchResult contiene los árboles obtenidos al analizar un lote de registros
+* independientes. Los nodos de todos los registros se reservan en una sola
+* arena y las raíces se guardan en un arreglo indexado por registro, por lo
+* que el lote se vacía de una vez y puede reutilizarse conservando la memoria.
+*
+* Los nodos hacen referencia al texto de los registros analizados, que debe
+* existir y no modificarse mientras se usa el lote.
+*/
+class BatchResult
+{
+    private:
+
+        /** Arena donde se reservan los nodos de todos los registros. */
+        Arena arena;
+
+        /** Raíz del árbol de cada registro, o NULL si no se reconoció. */
+        QVector<AstNode *> roots;
+
+        /** Cantidad de registros reconocidos. */
+        int matched;
+
+        /** Tabla de símbolos de la gramática que generó los árboles. */
+        const SymbolTable *symbols;
+
+        BatchResult(const BatchResult &);
+        BatchResult &operator=(const BatchResult &);
+
+    public:
+
+        /** Constructor, crea un lote vacío. */
+        BatchResult();
+
+        /** Retorna la cantidad de registros del lote. */
+        int size() const;
+
+        /** Retorna la cantidad de registros reconocidos. */
+        int matchedCount() const;
+
+        /**
+        * Retorna la raíz del árbol del registro index, o NULL si el registro
+        * no se reconoció.
+        */
+        AstNode *root(int index) const;
+
+        /**
+        * Agrega el resultado de un registro.
+        * @param root raíz del árbol reconocido o NULL.
+        */
+        void append(AstNode *root);
+
+        /**
+        * Descarta los resultados conservando la memoria para reutilizarla.
+        * @param capacity cantidad de registros que se espera agregar.
+        */
+        void clear(int capacity = 0);
+
+        /** Retorna la arena donde se reservan los nodos. */
+        Arena &nodeArena();
+
+        /** Retorna la tabla de símbolos de la gramática que generó los árboles. */
+        const SymbolTable *symbolTable() const;
+
+        /** Establece la tabla de símbolos de la gramática que genera los árboles. */
+        void setSymbolTable(const SymbolTable *symbols);
+};
+
+#endif // BATCHRESULT_H
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <binarysink.h>
+#include <astnode.h>
+#include <symboltable.h>
+
+BinarySink::BinarySink(QIODevice *device) {
+    this->device = device;
+}
+
+void BinarySink::begin() {
+    QDataStream out(device);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out.writeRawData(BINARY_MAGIC, 8);
+    out << quint32(BINARY_VERSION);
+}
+
+void BinarySink::writeRecord(RecordType type) {
+    QDataStream out(device);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << quint8(type) << quint32(record.size());
+    out.writeRawData(record.constData(), record.size());
+}
+
+void BinarySink::writeText(QDataStream &out, const QByteArray &text) {
+    out << quint32(text.size());
+    out.writeRawData(text.constData(), text.size());
+}
+
+void BinarySink::writeNode(QDataStream &out, AstNode *node, qint64 base) {
+    QStringRef textRef = node->getReference();
+    out << qint32(node->getTagName()) << qint32(node->getName())
+        << qint64(base + textRef.position()) << qint32(textRef.length())
+        << qint32(node->childCount());
+    for (AstNode *child = node->getFirstChild(); child;
+         child = child->getNextSibling()) {
+        writeNode(out, child, base);
+    }
+}
+
+quint32 BinarySink::tableId(const SymbolTable *symbols) {
+
+    /* Si la tabla ya se escribió y no ha cambiado se reutiliza su
+    identificador.*/
+    QHash<const SymbolTable *, QPair<quint32, int> >::const_iterator it =
+            tables.constFind(symbols);
+    if (it != tables.constEnd() && it.value().second == symbols->size()) {
+        return it.value().first;
+    }
+
+    quint32 id = it != tables.constEnd() ? it.value().first : tables.size();
+    tables.insert(symbols, qMakePair(id, symbols->size()));
+
+    record.clear();
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << id << quint32(symbols->size());
+    for (int i = 0; i < symbols->size(); ++i) {
+        writeText(out, symbols->name(i).toUtf8());
+    }
+    writeRecord(RecordSymbols);
+    return id;
+}
+
+void BinarySink::occurrence(const Occurrence &ocur) {
+    quint32 id = tableId(ocur.symbols);
+
+    record.clear();
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << id;
+    writeText(out, ocur.format.toUtf8());
+    out << qint64(ocur.offset) << qint64(ocur.byteOffset)
+        << qint64(ocur.nsecs);
+    writeText(out, ocur.input.toUtf8());
+    out << quint32(ocur.tree->nodeCount());
+    writeNode(out, ocur.tree, ocur.base());
+    writeRecord(RecordOccurrence);
+}
+
+void BinarySink::unknown(const QStringRef &text, qint64 offset) {
+    record.clear();
+    QDataStream out(&record, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << qint64(offset);
+    writeText(out, text.toUtf8());
+    writeRecord(RecordUnknown);
+}
@@ -0,0 +1,101 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef BINARYSINK_H
+#define BINARYSINK_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QDataStream>
+#include <QHash>
+#include <QPair>
+
+#include <outputsink.h>
+
+#define BINARY_MAGIC "GPTREE01"
+#define BINARY_VERSION 3
+
+/**
+* BinarySink escribe los resultados del análisis en un formato binario
+* compacto, a medida que se reconocen. Todos los enteros son little-endian y
+* los textos se escriben en UTF-8 precedidos de su longitud en bytes (quint32).
+*
+* El flujo comienza con la marca BINARY_MAGIC y la versión (quint32), seguidas
+* de registros formados por su tipo (quint8), la longitud en bytes del
+* contenido (quint32) y el contenido:
+* - RecordSymbols: identificador de la tabla (quint32), cantidad de símbolos
+*   (quint32) y cada símbolo como texto. Se escribe antes de la primera
+*   ocurrencia que utiliza la tabla.
+* - RecordOccurrence: identificador de la tabla (quint32), formato (texto),
+*   posición y posición en bytes en la entrada (qint64), nanosegundos (qint64),
+*   texto de la ocurrencia, cantidad de nodos (quint32) y los nodos en
+*   preorden, cada uno con etiqueta y nombre (qint32), posición (qint64),
+*   longitud y cantidad de hijos (qint32). Las posiciones de los nodos se
+*   expresan en unidades UTF-16 respecto al inicio de la entrada completa,
+*   igual que en la salida xml.
+* - RecordUnknown: posición en la entrada (qint64) y texto no reconocido.
+*/
+class BinarySink : public OutputSink
+{
+    public:
+
+        /** Tipos de registro. */
+        enum RecordType {
+            RecordSymbols = 1,
+            RecordOccurrence = 2,
+            RecordUnknown = 3
+        };
+
+    private:
+
+        /** Dispositivo donde se escriben los resultados. */
+        QIODevice *device;
+
+        /** Contenido del registro que se está construyendo. */
+        QByteArray record;
+
+        /**
+        * Identificador de cada tabla de símbolos escrita y cantidad de
+        * símbolos que tenía al escribirla.
+        */
+        QHash<const SymbolTable *, QPair<quint32, int> > tables;
+
+        /** Escribe el registro construido con el tipo type. */
+        void writeRecord(RecordType type);
+
+        /** Escribe text en UTF-8 precedido de su longitud. */
+        static void writeText(QDataStream &out, const QByteArray &text);
+
+        /**
+        * Escribe los nodos del árbol node en preorden, sumando base a sus
+        * posiciones.
+        */
+        static void writeNode(QDataStream &out, AstNode *node, qint64 base);
+
+        /**
+        * Retorna el identificador de la tabla symbols, escribiéndola si es
+        * nueva o cambió.
+        */
+        quint32 tableId(const SymbolTable *symbols);
+
+    public:
+
+        /**
+        * Constructor.
+        * @param device dispositivo abierto para escritura.
+        */
+        BinarySink(QIODevice *device);
+
+        /** Escribe la marca y la versión del formato. */
+        void begin();
+
+        /** Escribe el registro de la ocurrencia ocur. */
+        void occurrence(const Occurrence &ocur);
+
+        /** Escribe el registro del texto no reconocido. */
+        void unknown(const QStringRef &text, qint64 offset);
+};
+
+#endif // BINARYSINK_H
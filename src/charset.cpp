@@ -0,0 +1,104 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <charset.h>
+
+CharSet::CharSet() {
+    for (int i = 0; i < 8; ++i) {
+        this->bits[i] = 0;
+    }
+    this->others = false;
+}
+
+CharSet CharSet::full() {
+    CharSet result;
+    result.invert();
+    return result;
+}
+
+void CharSet::add(ushort c) {
+    if (c < 256) {
+        bits[c >> 5] |= quint32(1) << (c & 31);
+    } else {
+        others = true;
+    }
+}
+
+void CharSet::addRange(ushort first, ushort last) {
+    if (last > 255) {
+        others = true;
+        last = 255;
+    }
+    for (uint c = first; c <= last; ++c) {
+        bits[c >> 5] |= quint32(1) << (c & 31);
+    }
+}
+
+bool CharSet::unite(const CharSet &other) {
+    bool changed = other.others && !others;
+    others = others || other.others;
+    for (int i = 0; i < 8; ++i) {
+        quint32 merged = bits[i] | other.bits[i];
+        changed = changed || merged != bits[i];
+        bits[i] = merged;
+    }
+    return changed;
+}
+
+void CharSet::invert() {
+    for (int i = 0; i < 8; ++i) {
+        bits[i] = ~bits[i];
+    }
+    others = true;
+}
+
+bool CharSet::isEmpty() const {
+    for (int i = 0; i < 8; ++i) {
+        if (bits[i]) {
+            return false;
+        }
+    }
+    return !others;
+}
+
+bool CharSet::isFull() const {
+    for (int i = 0; i < 8; ++i) {
+        if (bits[i] != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return others;
+}
+
+int CharSet::indexIn(const QStringRef &text) const {
+    if (text.isEmpty()) {
+        return -1;
+    }
+    if (isFull()) {
+        return 0;
+    }
+
+    const QChar *data = text.unicode();
+    int length = text.length();
+    for (int i = 0; i < length; ++i) {
+        if (contains(data[i].unicode())) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool CharSet::occursIn(const QStringRef &text) const {
+    return indexIn(text) != -1;
+}
+
+bool CharSet::operator==(const CharSet &other) const {
+    for (int i = 0; i < 8; ++i) {
+        if (bits[i] != other.bits[i]) {
+            return false;
+        }
+    }
+    return others == other.others;
+}
@@ -0,0 +1,82 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef CHARSET_H
+#define CHARSET_H
+
+#include <QChar>
+#include <QStringRef>
+
+/**
+* CharSet representa un conjunto de caracteres UTF-16. Los caracteres Latin-1
+* se guardan en un mapa de bits; del resto solo se conoce si alguno puede
+* pertenecer al conjunto.
+*/
+class CharSet
+{
+    private:
+
+        /** Mapa de bits de los caracteres del 0 al 255. */
+        quint32 bits[8];
+
+        /** Indica si el conjunto puede contener caracteres mayores que 255. */
+        bool others;
+
+    public:
+
+        /** Constructor, crea un conjunto vacío. */
+        CharSet();
+
+        /** Retorna un conjunto con todos los caracteres. */
+        static CharSet full();
+
+        /** Agrega el carácter c. */
+        void add(ushort c);
+
+        /** Agrega los caracteres desde first hasta last, ambos incluidos. */
+        void addRange(ushort first, ushort last);
+
+        /**
+        * Agrega los caracteres de other.
+        * @return Devuelve true si el conjunto cambió.
+        */
+        bool unite(const CharSet &other);
+
+        /**
+        * Sustituye el conjunto por su complemento. Como del resto de los
+        * caracteres no se conoce cuáles pertenecen, el complemento siempre
+        * puede contenerlos.
+        */
+        void invert();
+
+        /** Retorna si el conjunto está vacío. */
+        bool isEmpty() const;
+
+        /** Retorna si el conjunto contiene todos los caracteres. */
+        bool isFull() const;
+
+        /** Retorna si el carácter c puede pertenecer al conjunto. */
+        inline bool contains(ushort c) const {
+            return c < 256 ? (bits[c >> 5] >> (c & 31)) & 1 : others;
+        }
+
+        /**
+        * Busca el primer carácter del texto referenciado que puede pertenecer
+        * al conjunto.
+        * @return Devuelve su posición relativa al inicio de la referencia o -1
+        * si ninguno pertenece.
+        */
+        int indexIn(const QStringRef &text) const;
+
+        /**
+        * Retorna si alguno de los caracteres del texto referenciado puede
+        * pertenecer al conjunto.
+        */
+        bool occursIn(const QStringRef &text) const;
+
+        bool operator==(const CharSet &other) const;
+};
+
+#endif // CHARSET_H
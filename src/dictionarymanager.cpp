@@ -4,86 +4,278 @@
  */
 
 #include <QDebug>
+#include <QDateTime>
+#include <QStringList>
 
 #include <dictionarymanager.h>
+#include <dictionarymatcher.h>
 
-DictionaryManager::DictionaryManager(QDir dir) {
+/** Calcula el resumen FNV-1a de 64 bits de data. */
+static quint64 contentHash(const QByteArray &data) {
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+    for (int i = 0; i < data.size(); ++i) {
+        hash ^= bytes[i];
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash;
+}
 
+DictionaryManager::DictionaryManager(QDir dir) {
     this->directory = dir;
+    this->snapshotsEnabled = false;
+    this->generationCount.storeRelease(0);
+    this->dictionaries.storeRelease(new DictionaryTable());
+}
+
+DictionaryManager::~DictionaryManager() {
+    const DictionaryTable *table = dictionaries.loadAcquire();
+    for (DictionaryTable::const_iterator it = table->constBegin();
+         it != table->constEnd(); ++it) {
+        delete it.value();
+    }
+    delete table;
+    releaseRetired();
+}
+
+const DictionaryMatcher *DictionaryManager::getDictionary(QString key) {
+
+    /* Se obtiene el diccionario cuyo nombre es el valor de 'key' de la tabla
+    publicada, en caso de haber sido cargado este es retornado.*/
+    const DictionaryTable *table = dictionaries.loadAcquire();
+    DictionaryTable::const_iterator it = table->constFind(key);
+    if (it != table->constEnd()) {
+        return it.value();
+    }
+
+    /* Si no se ha cargado el diccionario se carga desde un fichero. Se
+    comprueba de nuevo con el bloqueo, ya que otro hilo pudo cargarlo.*/
+    QMutexLocker locker(&writeMutex);
+    table = dictionaries.loadAcquire();
+    it = table->constFind(key);
+    if (it != table->constEnd()) {
+        return it.value();
+    }
+
+    DictionarySource stamp;
+    const DictionaryMatcher *matcher = buildMatcher(key, &stamp);
+    publish(key, matcher, stamp);
+    return matcher;
 }
 
-QRegExp DictionaryManager::getDictionary(QString key) {
+const DictionaryMatcher *DictionaryManager::loadDictionary(QString key) {
+
+    /* El autómata se construye sin bloqueo; solo su publicación se
+    serializa.*/
+    DictionarySource stamp;
+    const DictionaryMatcher *matcher = buildMatcher(key, &stamp);
+
+    QMutexLocker locker(&writeMutex);
 
-    /* Se obtiene el diccionario cuyo nombre es el valor de 'key', en caso de
-    ser válida la expresión regular obtenida esta es retornada.*/
-    QRegExp regexp = dictionaries[key];
-    if (!regexp.isEmpty()) {
-        return regexp;
+    /* Si falla la recarga de un diccionario ya cargado, por ejemplo porque
+    el fichero se está escribiendo, se conserva el autómata publicado y su
+    estado, de forma que reloadModified lo intente de nuevo.*/
+    if (!matcher && dictionaries.loadAcquire()->value(key)) {
+        qCritical() << "Parser: No se pudo recargar el diccionario" << key
+                    << ", se conserva el anterior";
+        return NULL;
     }
 
-    /* Si no se obtiene una expresión regular correcta se intenta cargala desde
-    un fichero.*/
-    return loadDictionary(key);
+    publish(key, matcher, stamp);
+    return matcher;
 }
 
-QRegExp DictionaryManager::loadDictionary(QString key) {
+DictionaryMatcher *DictionaryManager::buildMatcher(QString key,
+                                                   DictionarySource *stamp) {
+
+    QFileInfo sourceInfo(directory.absoluteFilePath(key + DICTIONARY_SUFFIX));
+    *stamp = fileStamp(key);
+
+    /* Si existe una imagen precompilada vigente se proyecta en memoria, de lo
+    contrario se construye el autómata y se intenta guardar su imagen.*/
+    DictionaryMatcher *matcher = NULL;
+    if (snapshotsEnabled) {
+        matcher = loadSnapshot(key, sourceInfo);
+    }
+    if (!matcher) {
+        matcher = compileDictionary(key);
+        if (!matcher) {
+            return NULL;
+        }
+        if (snapshotsEnabled && !matcher->save(directory.absoluteFilePath(
+                                                   key + SNAPSHOT_SUFFIX))) {
+            qWarning() << "Parser: No se pudo guardar la imagen del diccionario"
+                       << key;
+        }
+    }
+
+    if (matcher->isEmpty()) {
+        qCritical() << "Parser: El diccionario" << key << "no contiene palabras";
+        delete matcher;
+        return NULL;
+    }
+
+    return matcher;
+}
+
+void DictionaryManager::publish(QString key, const DictionaryMatcher *matcher,
+                                const DictionarySource &stamp) {
+
+    /* Se crea una copia de la tabla con el nuevo autómata y se publica. La
+    tabla y el autómata anteriores se retiran, ya que algún análisis puede
+    seguir usándolos.*/
+    const DictionaryTable *current = dictionaries.loadAcquire();
+    DictionaryTable *next = new DictionaryTable(*current);
+    const DictionaryMatcher *previous = next->value(key);
+    next->insert(key, matcher);
+    stamps.insert(key, stamp);
+
+    dictionaries.storeRelease(next);
+    generationCount.fetchAndAddRelease(1);
+    retiredTables.append(current);
+    if (previous && previous != matcher) {
+        retiredMatchers.append(previous);
+    }
+}
+
+DictionarySource DictionaryManager::fileStamp(QString key) {
+    QFileInfo info(directory.absoluteFilePath(key + DICTIONARY_SUFFIX));
+    DictionarySource stamp;
+    stamp.size = info.exists() ? info.size() : -1;
+    stamp.modified = info.exists() ?
+                info.lastModified().toMSecsSinceEpoch() : -1;
+    stamp.hash = 0;
+    return stamp;
+}
+
+int DictionaryManager::reloadModified() {
+    QHash<QString, DictionarySource> loaded;
+    writeMutex.lock();
+    loaded = stamps;
+    writeMutex.unlock();
+
+    /* Se recargan los diccionarios cuyo fichero cambió desde que se
+    cargaron.*/
+    int count = 0;
+    for (QHash<QString, DictionarySource>::const_iterator it =
+         loaded.constBegin(); it != loaded.constEnd(); ++it) {
+        DictionarySource current = fileStamp(it.key());
+        if (current.size != it.value().size ||
+                current.modified != it.value().modified) {
+            if (loadDictionary(it.key())) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+int DictionaryManager::generation() const {
+    return generationCount.loadAcquire();
+}
+
+void DictionaryManager::releaseRetired() {
+    QMutexLocker locker(&writeMutex);
+    qDeleteAll(retiredMatchers);
+    retiredMatchers.clear();
+    qDeleteAll(retiredTables);
+    retiredTables.clear();
+}
+
+DictionaryMatcher *DictionaryManager::compileDictionary(QString key) {
 
     /* Se intenta abrir el fichero correspondiente al diccionario cuyo nombre
     es 'key'.*/
-    QFile dictionaryFile(directory.absoluteFilePath(key + ".dic"));
-    if (!dictionaryFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    QFile dictionaryFile(directory.absoluteFilePath(key + DICTIONARY_SUFFIX));
+    if (!dictionaryFile.open(QIODevice::ReadOnly)) {
         qCritical() << "Parser: No se pudo abrir el fichero" << key + ".dic";
-        return QRegExp();
+        return NULL;
     }
 
-    /* Si se logra abrir el fichero se leen todos los elementos del diccionario
-    y se genera una expresón regular.*/
-    QString regexpStr;
-    while (!dictionaryFile.atEnd()) {
-        QByteArray line = dictionaryFile.readLine();
-        if (line.isEmpty()) {
-            continue;
-        }
+    QByteArray content = dictionaryFile.readAll();
+    DictionarySource source;
+    source.size = content.size();
+    source.modified = QFileInfo(dictionaryFile).lastModified().toMSecsSinceEpoch();
+    source.hash = contentHash(content);
+    dictionaryFile.close();
 
-        /* Se escapan caracteres especiales.*/
-        line.replace('\\', "\\\\");
-        line.replace('(', "\\(");
-        line.replace(')', "\\)");
-        line.replace('{', "\\{");
-        line.replace('}', "\\}");
-        line.replace('[', "\\[");
-        line.replace(']', "\\]");
-        line.replace('|', "\\|");
-        line.replace('.', "\\.");
-        line.replace('*', "\\*");
-        line.replace('+', "\\+");
-        line.replace('?', "\\?");
-        line.replace('^', "\\^");
-        line.replace('$', "\\$");
+    /* Se leen todos los elementos del diccionario, uno por línea.*/
+    QStringList words;
+    int begin = 0;
+    while (begin < content.size()) {
+        int end = content.indexOf('\n', begin);
+        if (end == -1) {
+            end = content.size();
+        }
 
         /* Se elimina el caracter de fin de linea.*/
-        line.replace('\n', "");
-
-        if (!regexpStr.isEmpty()) {
-            line.push_front('|');
+        int length = end - begin;
+        if (length > 0 && content.at(end - 1) == '\r') {
+            length--;
+        }
+        if (length > 0) {
+            words.append(QString::fromUtf8(content.constData() + begin, length));
         }
+        begin = end + 1;
+    }
+
+    /* Se construye el autómata que reconoce las palabras del diccionario.*/
+    DictionaryMatcher *matcher = new DictionaryMatcher();
+    matcher->build(words, source);
+    return matcher;
+}
 
-        regexpStr.append(line);
+DictionaryMatcher *DictionaryManager::loadSnapshot(QString key,
+                                                   const QFileInfo &sourceInfo) {
+    if (!sourceInfo.exists()) {
+        return NULL;
+    }
+
+    DictionaryMatcher *matcher = new DictionaryMatcher();
+    if (!matcher->map(directory.absoluteFilePath(key + SNAPSHOT_SUFFIX))) {
+        delete matcher;
+        return NULL;
     }
-    dictionaryFile.close();
-    regexpStr.push_front("\\b(");
-    regexpStr.push_back(")\\b");
 
-    QRegExp regexp = QRegExp(regexpStr);
-    if (!regexp.isValid()) {
-        qCritical() << "Parser: La expresion regular para el diccionario" <<
-                       key << "no es correcta";
-        return QRegExp();
+    /* La imagen es vigente si el fichero .dic conserva el tamaño y la fecha de
+    modificación con que se generó.*/
+    DictionarySource source = matcher->source();
+    if (source.size == sourceInfo.size() &&
+            source.modified == sourceInfo.lastModified().toMSecsSinceEpoch()) {
+        return matcher;
     }
 
-    /* Si la expresión regular generada es correcta se agrega en la tabla hash
-    de diccionarios.*/
-    dictionaries.insert(key, regexp);
+    /* Si solo cambió la fecha de modificación se compara el contenido. Si
+    coincide se guarda la imagen con la nueva fecha, para no tener que leer el
+    fichero .dic completo en las cargas siguientes.*/
+    if (source.size == sourceInfo.size()) {
+        QFile dictionaryFile(sourceInfo.absoluteFilePath());
+        if (dictionaryFile.open(QIODevice::ReadOnly) &&
+                contentHash(dictionaryFile.readAll()) == source.hash) {
+            source.modified = sourceInfo.lastModified().toMSecsSinceEpoch();
+            if (!matcher->save(directory.absoluteFilePath(key + SNAPSHOT_SUFFIX),
+                               source)) {
+                qWarning() << "Parser: No se pudo actualizar la imagen del"
+                           << "diccionario" << key;
+            }
+            return matcher;
+        }
+    }
+
+    delete matcher;
+    return NULL;
+}
+
+bool DictionaryManager::buildSnapshot(QString key) {
+    DictionaryMatcher *matcher = compileDictionary(key);
+    if (!matcher) {
+        return false;
+    }
+    bool saved = matcher->save(directory.absoluteFilePath(key + SNAPSHOT_SUFFIX));
+    delete matcher;
+    return saved;
+}
 
-    return regexp;
+void DictionaryManager::setSnapshotsEnabled(bool enabled) {
+    this->snapshotsEnabled = enabled;
 }
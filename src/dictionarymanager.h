@@ -8,10 +8,31 @@
 
 #include <QDir>
 #include <QHash>
+#include <QFileInfo>
+#include <QList>
+#include <QMutex>
+#include <QAtomicPointer>
+
+#include <dictionarymatcher.h>
+
+#define DICTIONARY_SUFFIX ".dic"
+#define SNAPSHOT_SUFFIX ".dic.bin"
+
+/**
+* Tabla de autómatas por nombre de diccionario. Una tabla publicada nunca se
+* modifica; los cambios se hacen sobre una copia que la sustituye.
+*/
+typedef QHash<QString, const DictionaryMatcher *> DictionaryTable;
 
 /**
 * DictionaryManager es la clase encargada de gestionar el trabajo con los
 * diccionarios utilizados por la clase Parser.
+*
+* Los autómatas se publican en una tabla inmutable que se sustituye de forma
+* atómica, por lo que varios hilos pueden consultar los diccionarios sin
+* bloqueos mientras otro los carga o recarga. Las tablas y autómatas
+* sustituidos se conservan hasta que se destruye el gestor o se invoca
+* releaseRetired, ya que algún análisis en curso puede seguir usándolos.
 */
 class DictionaryManager
 {
@@ -21,10 +42,69 @@ class DictionaryManager
         QDir directory;
 
         /**
-        * Tabla hash donde se guardan las expresiones regulares para cada
-        * elemnto gramatical definido por diccionario.
+        * Tabla hash publicada donde se guardan los autómatas de reconocimiento
+        * para cada elemnto gramatical definido por diccionario. Un valor NULL
+        * indica que el diccionario no se pudo cargar.
+        */
+        QAtomicPointer<const DictionaryTable> dictionaries;
+
+        /** Cantidad de tablas publicadas. */
+        QAtomicInt generationCount;
+
+        /** Serializa la carga y publicación de diccionarios. */
+        QMutex writeMutex;
+
+        /** Tablas sustituidas que aún pueden estar en uso. */
+        QList<const DictionaryTable *> retiredTables;
+
+        /** Autómatas sustituidos que aún pueden estar en uso. */
+        QList<const DictionaryMatcher *> retiredMatchers;
+
+        /**
+        * Estado de cada fichero .dic al cargarlo, para detectar los
+        * diccionarios modificados.
         */
-        QHash<QString, QRegExp> dictionaries;
+        QHash<QString, DictionarySource> stamps;
+
+        /** Indica si se utilizan las imágenes precompiladas de diccionarios. */
+        bool snapshotsEnabled;
+
+        /**
+        * Construye el autómata del diccionario key a partir del fichero .dic.
+        * @param key nombre del diccionario.
+        * @return Devuelve el autómata construido o NULL si no se pudo leer el
+        * fichero.
+        */
+        DictionaryMatcher *compileDictionary(QString key);
+
+        /**
+        * Proyecta en memoria la imagen precompilada del diccionario key si
+        * existe y corresponde al contenido actual del fichero .dic.
+        * @param key nombre del diccionario.
+        * @param sourceInfo información del fichero .dic.
+        * @return Devuelve el autómata proyectado o NULL si la imagen no existe
+        * o está desactualizada.
+        */
+        DictionaryMatcher *loadSnapshot(QString key, const QFileInfo &sourceInfo);
+
+        /**
+        * Construye el autómata del diccionario key a partir de su imagen
+        * precompilada o del fichero .dic, sin publicarlo.
+        * @param key nombre del diccionario.
+        * @param stamp estado del fichero .dic antes de leerlo.
+        * @return Devuelve el autómata o NULL si no se pudo cargar.
+        */
+        DictionaryMatcher *buildMatcher(QString key, DictionarySource *stamp);
+
+        /**
+        * Publica una nueva tabla donde el diccionario key tiene el autómata
+        * matcher. Se debe invocar con writeMutex bloqueado.
+        */
+        void publish(QString key, const DictionaryMatcher *matcher,
+                     const DictionarySource &stamp);
+
+        /** Retorna el tamaño y la fecha de modificación del fichero .dic. */
+        DictionarySource fileStamp(QString key);
 
     public:
 
@@ -34,27 +114,73 @@ class DictionaryManager
         */
         DictionaryManager(QDir dir);
 
+        /** Destructor. */
+        ~DictionaryManager();
+
         /**
-        * Retorna la expresion regular del diccionario del elemento gramatical
-        * de nombre key. Si no se encuentra el diccionario entrega una expresón
-        * regular vacía.
+        * Retorna el autómata del diccionario del elemento gramatical de nombre
+        * key, cargándolo la primera vez que se solicita. Si no se encuentra el
+        * diccionario entrega NULL, y no se vuelve a intentar cargar hasta que
+        * se invoque loadDictionary o reloadModified. La consulta de un
+        * diccionario ya cargado no utiliza bloqueos.
         * @param key nombre del diccionario.
-        * @return Devuelve la expresión regular para el diccionario key.
+        * @return Devuelve el autómata para el diccionario key.
         * @see loadDictionary
         */
-        QRegExp getDictionary(QString key);
+        const DictionaryMatcher *getDictionary(QString key);
 
         /**
         * Carga el diccionario de nombre key desde un fichero de igual nombre y
-        * luego retorna la expresión regular correspondiente. Si no se puede
-        * formar correctamente la expresión regular, una expresón regular vacía
-        * es retornada.
+        * luego retorna el autómata correspondiente. Si no se puede leer el
+        * fichero o no contiene palabras, se retorna NULL; si el diccionario
+        * ya estaba cargado se conserva el autómata anterior. El autómata se
+        * construye fuera del bloqueo y sustituye al anterior de forma
+        * atómica, por lo que puede invocarse mientras otros hilos analizan.
         * @param key nombre del diccionario.
-        * @return Devuelve la expresión regular para el diccionario key.
+        * @return Devuelve el autómata para el diccionario key.
         * @see getDictionary
         */
-        QRegExp loadDictionary(QString key);
+        const DictionaryMatcher *loadDictionary(QString key);
+
+        /**
+        * Construye el autómata del diccionario key y lo guarda como imagen
+        * binaria junto al fichero .dic, con extensión ".dic.bin". La imagen
+        * se invalida cuando cambian el tamaño, la fecha de modificación y el
+        * contenido del fichero .dic.
+        * @param key nombre del diccionario.
+        * @return Devuelve true si se pudo escribir la imagen.
+        */
+        bool buildSnapshot(QString key);
 
+        /**
+        * Establece si al cargar un diccionario se utiliza su imagen
+        * precompilada, generándola cuando no existe o está desactualizada. Por
+        * defecto está desactivado, por lo que cargar un diccionario no
+        * escribe en el directorio de configuración.
+        */
+        void setSnapshotsEnabled(bool enabled);
+
+        /**
+        * Vuelve a cargar los diccionarios cuyo fichero .dic cambió de tamaño
+        * o fecha de modificación desde que se cargaron. Los que no se pueden
+        * recargar conservan el autómata anterior y se intentan de nuevo en la
+        * próxima invocación.
+        * @return Devuelve la cantidad de diccionarios recargados.
+        */
+        int reloadModified();
+
+        /**
+        * Retorna un número que cambia cada vez que se carga, recarga o no se
+        * encuentra un diccionario, para detectar que los datos calculados a
+        * partir de los autómatas están desactualizados.
+        */
+        int generation() const;
+
+        /**
+        * Libera las tablas y autómatas sustituidos. Solo se debe invocar
+        * cuando no hay análisis en curso que puedan estar usándolos.
+        */
+        void releaseRetired();
 };
 
 #endif // DICTIONARYMANAGER_H
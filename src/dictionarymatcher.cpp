@@ -0,0 +1,403 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <QSaveFile>
+#include <QVector>
+
+#include <dictionarymatcher.h>
+
+/** Redondea offset al siguiente múltiplo de 8. */
+static qint64 align8(qint64 offset) {
+    return (offset + 7) & ~qint64(7);
+}
+
+DictionaryMatcher::DictionaryMatcher() {
+    this->mappedFile = NULL;
+    this->header = NULL;
+    this->nodes = NULL;
+    this->edges = NULL;
+}
+
+DictionaryMatcher::~DictionaryMatcher() {
+    release();
+}
+
+void DictionaryMatcher::release() {
+    header = NULL;
+    nodes = NULL;
+    edges = NULL;
+    image.clear();
+    if (mappedFile) {
+        mappedFile->close();
+        delete mappedFile;
+        mappedFile = NULL;
+    }
+}
+
+bool DictionaryMatcher::attach(const uchar *data, qint64 size) {
+    if (size < qint64(sizeof(Header))) {
+        return false;
+    }
+
+    /* Se comprueba que la cabecera corresponda a una imagen de esta versión
+    generada en una máquina con el mismo orden de bytes.*/
+    const Header *head = reinterpret_cast<const Header *>(data);
+    if (qstrncmp(head->magic, SNAPSHOT_MAGIC, sizeof(head->magic)) != 0 ||
+            head->version != SNAPSHOT_VERSION ||
+            head->byteOrder != SNAPSHOT_BYTE_ORDER ||
+            head->nodeCount < 1 || head->edgeCount < 0) {
+        return false;
+    }
+
+    /* Se comprueba que los arreglos estén contenidos en la imagen.*/
+    if (head->nodesOffset < qint64(sizeof(Header)) ||
+            head->nodesOffset + head->nodeCount * qint64(sizeof(Node)) > size ||
+            head->edgesOffset < head->nodesOffset ||
+            head->edgesOffset + head->edgeCount * qint64(sizeof(Edge)) > size) {
+        return false;
+    }
+
+    header = head;
+    nodes = reinterpret_cast<const Node *>(data + head->nodesOffset);
+    edges = reinterpret_cast<const Edge *>(data + head->edgesOffset);
+    return true;
+}
+
+bool DictionaryMatcher::isConsistent() const {
+    int nodeCount = header->nodeCount;
+    int edgeCount = header->edgeCount;
+    if (header->maxLength < 0 || header->wordCount < 0) {
+        return false;
+    }
+
+    /* Los estados están numerados en orden de anchura, por lo que la
+    profundidad de cada destino se conoce al recorrer su estado origen.*/
+    QVector<int> depth(nodeCount, -1);
+    depth[0] = 0;
+    for (int u = 0; u < nodeCount; ++u) {
+        const Node &node = nodes[u];
+        if (depth.at(u) == -1 || node.firstEdge < 0 || node.edgeCount < 0 ||
+                node.edgeCount > edgeCount - node.firstEdge) {
+            return false;
+        }
+
+        /* El estado de fallo de la raíz es ella misma; en el resto es un
+        estado anterior, con lo que las cadenas de fallos siempre terminan.*/
+        if (u == 0 ? node.fail != 0 : (node.fail < 0 || node.fail >= u)) {
+            return false;
+        }
+        if (node.outputLink < -1 || node.outputLink >= u) {
+            return false;
+        }
+        if (node.output != 0 && (node.output != depth.at(u) ||
+                                 node.output > header->maxLength)) {
+            return false;
+        }
+
+        int end = node.firstEdge + node.edgeCount;
+        for (int e = node.firstEdge; e < end; ++e) {
+            int target = edges[e].target;
+            if (target <= u || target >= nodeCount || depth.at(target) != -1) {
+                return false;
+            }
+            depth[target] = depth.at(u) + 1;
+        }
+    }
+    return true;
+}
+
+void DictionaryMatcher::build(QStringList words, DictionarySource source) {
+    release();
+
+    /* Al ordenar las palabras, los hijos de cada estado del árbol de prefijos
+    se crean en orden creciente de carácter y solo es necesario comparar con
+    el último hijo creado.*/
+    words.sort();
+    words.removeDuplicates();
+
+    QVector<ushort> symbol;
+    QVector<int> firstChild;
+    QVector<int> lastChild;
+    QVector<int> nextSibling;
+    QVector<int> output;
+    int maxLength = 0;
+    int wordCount = 0;
+
+    symbol.append(0);
+    firstChild.append(-1);
+    lastChild.append(-1);
+    nextSibling.append(-1);
+    output.append(0);
+
+    for (int i = 0; i < words.size(); ++i) {
+        const QString &word = words.at(i);
+        if (word.isEmpty()) {
+            continue;
+        }
+
+        int node = 0;
+        for (int j = 0; j < word.length(); ++j) {
+            ushort c = word.at(j).unicode();
+            int child = lastChild.at(node);
+            if (child == -1 || symbol.at(child) != c) {
+                child = symbol.size();
+                symbol.append(c);
+                firstChild.append(-1);
+                lastChild.append(-1);
+                nextSibling.append(-1);
+                output.append(0);
+                if (lastChild.at(node) == -1) {
+                    firstChild[node] = child;
+                } else {
+                    nextSibling[lastChild.at(node)] = child;
+                }
+                lastChild[node] = child;
+            }
+            node = child;
+        }
+        output[node] = word.length();
+        maxLength = qMax(maxLength, word.length());
+        wordCount++;
+    }
+
+    /* Se reserva la imagen completa: cabecera, estados y transiciones.*/
+    int nodeCount = symbol.size();
+    int edgeCount = nodeCount - 1;
+    qint64 nodesOffset = align8(sizeof(Header));
+    qint64 edgesOffset = align8(nodesOffset + nodeCount * qint64(sizeof(Node)));
+    image.fill(0, int(edgesOffset + edgeCount * qint64(sizeof(Edge))));
+
+    char *data = image.data();
+    Header *head = reinterpret_cast<Header *>(data);
+    memcpy(head->magic, SNAPSHOT_MAGIC, sizeof(head->magic));
+    head->version = SNAPSHOT_VERSION;
+    head->byteOrder = SNAPSHOT_BYTE_ORDER;
+    head->source = source;
+    head->nodeCount = nodeCount;
+    head->edgeCount = edgeCount;
+    head->maxLength = maxLength;
+    head->wordCount = wordCount;
+    head->nodesOffset = nodesOffset;
+    head->edgesOffset = edgesOffset;
+    Node *nodeData = reinterpret_cast<Node *>(data + nodesOffset);
+    Edge *edgeData = reinterpret_cast<Edge *>(data + edgesOffset);
+
+    /* Se renumeran los estados en orden de anchura para que las transiciones
+    de cada estado queden contiguas y ordenadas.*/
+    QVector<int> queue;
+    queue.reserve(nodeCount);
+    queue.append(0);
+    int edgeIndex = 0;
+    for (int index = 0; index < queue.size(); ++index) {
+        int t = queue.at(index);
+        Node &node = nodeData[index];
+        node.firstEdge = edgeIndex;
+        node.edgeCount = 0;
+        node.fail = 0;
+        node.output = output.at(t);
+        node.outputLink = -1;
+        for (int c = firstChild.at(t); c != -1; c = nextSibling.at(c)) {
+            Edge &edge = edgeData[edgeIndex++];
+            edge.symbol = symbol.at(c);
+            edge.target = queue.size();
+            queue.append(c);
+            node.edgeCount++;
+        }
+    }
+
+    attach(reinterpret_cast<const uchar *>(image.constData()), image.size());
+
+    /* Se calculan los estados de fallo en orden de anchura, de forma que el
+    estado de fallo de cada destino ya esté resuelto.*/
+    for (int u = 0; u < nodeCount; ++u) {
+        int end = nodeData[u].firstEdge + nodeData[u].edgeCount;
+        for (int e = nodeData[u].firstEdge; e < end; ++e) {
+            ushort c = edgeData[e].symbol;
+            int v = edgeData[e].target;
+            int fail = 0;
+            if (u != 0) {
+                int f = nodeData[u].fail;
+                int next;
+                while ((next = transition(f, c)) == -1 && f != 0) {
+                    f = nodeData[f].fail;
+                }
+                fail = next == -1 ? 0 : next;
+            }
+            nodeData[v].fail = fail;
+            nodeData[v].outputLink = nodeData[fail].output > 0 ? fail :
+                                                                 nodeData[fail].outputLink;
+        }
+    }
+}
+
+bool DictionaryMatcher::save(const QString &path) const {
+    if (!header) {
+        return false;
+    }
+    return save(path, header->source);
+}
+
+bool DictionaryMatcher::save(const QString &path,
+                             const DictionarySource &source) const {
+    if (!header) {
+        return false;
+    }
+
+    /* Se escribe primero un fichero temporal que sustituye al anterior solo
+    si la escritura termina correctamente.*/
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    Header head = *header;
+    head.source = source;
+    qint64 size = header->edgesOffset + header->edgeCount * qint64(sizeof(Edge));
+    qint64 rest = size - qint64(sizeof(Header));
+    if (file.write(reinterpret_cast<const char *>(&head), sizeof(Header)) !=
+            qint64(sizeof(Header)) ||
+            file.write(reinterpret_cast<const char *>(header + 1), rest) != rest) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool DictionaryMatcher::map(const QString &path) {
+    release();
+
+    QFile *file = new QFile(path);
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        return false;
+    }
+
+    qint64 size = file->size();
+    uchar *data = size > 0 ? file->map(0, size) : NULL;
+    if (!data || !attach(data, size) || !isConsistent()) {
+        file->close();
+        delete file;
+        header = NULL;
+        nodes = NULL;
+        edges = NULL;
+        return false;
+    }
+
+    mappedFile = file;
+    return true;
+}
+
+DictionarySource DictionaryMatcher::source() const {
+    if (!header) {
+        DictionarySource empty = { -1, -1, 0 };
+        return empty;
+    }
+    return header->source;
+}
+
+bool DictionaryMatcher::isMapped() const {
+    return mappedFile != NULL;
+}
+
+int DictionaryMatcher::transition(int state, ushort symbol) const {
+    const Node &node = nodes[state];
+    int begin = node.firstEdge;
+    int end = node.firstEdge + node.edgeCount;
+
+    /* Búsqueda binaria del carácter entre las transiciones del estado.*/
+    while (begin < end) {
+        int pivot = (begin + end) / 2;
+        ushort test = edges[pivot].symbol;
+        if (test == symbol) {
+            return edges[pivot].target;
+        } else if (test < symbol) {
+            begin = pivot + 1;
+        } else {
+            end = pivot;
+        }
+    }
+    return -1;
+}
+
+bool DictionaryMatcher::isBoundary(const QStringRef &text, int pos) {
+    bool before = false;
+    bool after = false;
+    if (pos > 0) {
+        QChar c = text.at(pos - 1);
+        before = c.isLetterOrNumber() || c.isMark() || c == QLatin1Char('_');
+    }
+    if (pos < text.length()) {
+        QChar c = text.at(pos);
+        after = c.isLetterOrNumber() || c.isMark() || c == QLatin1Char('_');
+    }
+    return before != after;
+}
+
+bool DictionaryMatcher::isEmpty() const {
+    return !header || header->wordCount == 0;
+}
+
+int DictionaryMatcher::size() const {
+    return header ? header->wordCount : 0;
+}
+
+int DictionaryMatcher::indexIn(const QStringRef &text, int *matchedLength) const {
+    if (isEmpty()) {
+        return -1;
+    }
+
+    const QChar *data = text.unicode();
+    int length = text.length();
+    int maxLength = header->maxLength;
+    int state = 0;
+    int bestStart = -1;
+    int bestLength = 0;
+
+    for (int i = 0; i < length; ++i) {
+
+        /* Si ninguna palabra que termine en esta posición puede comenzar
+        antes de la mejor coincidencia se termina la búsqueda.*/
+        if (bestStart != -1 && i - maxLength + 1 > bestStart) {
+            break;
+        }
+
+        ushort c = data[i].unicode();
+        int next;
+        while ((next = transition(state, c)) == -1 && state != 0) {
+            state = nodes[state].fail;
+        }
+        state = next == -1 ? 0 : next;
+
+        /* Se comprueban todas las palabras que terminan en esta posición.*/
+        int out = nodes[state].output > 0 ? state : nodes[state].outputLink;
+        while (out != -1) {
+            int wordLength = nodes[out].output;
+            int start = i - wordLength + 1;
+            if ((bestStart == -1 || start < bestStart ||
+                 (start == bestStart && wordLength > bestLength)) &&
+                    isBoundary(text, start) && isBoundary(text, i + 1)) {
+                bestStart = start;
+                bestLength = wordLength;
+            }
+            out = nodes[out].outputLink;
+        }
+    }
+
+    if (bestStart != -1) {
+        *matchedLength = bestLength;
+    }
+    return bestStart;
+}
+
+void DictionaryMatcher::firstChars(CharSet *first) const {
+    if (!header) {
+        return;
+    }
+
+    /* Las transiciones de la raíz son las primeras letras de las palabras.*/
+    const Node &root = nodes[0];
+    for (int i = 0; i < root.edgeCount; ++i) {
+        first->add(edges[root.firstEdge + i].symbol);
+    }
+}
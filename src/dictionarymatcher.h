@@ -0,0 +1,219 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef DICTIONARYMATCHER_H
+#define DICTIONARYMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringRef>
+#include <QByteArray>
+#include <QFile>
+
+#include <charset.h>
+
+#define SNAPSHOT_MAGIC "GPDICT01"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304
+
+/**
+* DictionarySource identifica el contenido del fichero .dic a partir del cual
+* se construyó un autómata, para detectar si una imagen precompilada está
+* desactualizada.
+*/
+struct DictionarySource
+{
+    /** Tamaño en bytes del fichero. */
+    qint64 size;
+
+    /** Fecha de modificación en milisegundos desde la época. */
+    qint64 modified;
+
+    /** Resumen FNV-1a de 64 bits del contenido. */
+    quint64 hash;
+};
+
+/**
+* DictionaryMatcher reconoce las palabras de un diccionario mediante un
+* autómata de Aho-Corasick. Una palabra solo se reconoce si está delimitada por
+* límites de palabra en ambos extremos, igual que la expresión "\b(...)\b" que
+* se utilizaba antes, y se reporta la coincidencia más a la izquierda y, entre
+* estas, la más larga. El tiempo de búsqueda es lineal respecto al texto
+* analizado e independiente de la cantidad de palabras.
+*
+* El autómata se representa como una imagen binaria independiente de la
+* posición en memoria (una cabecera seguida de los arreglos de estados y
+* transiciones), que puede guardarse junto al fichero .dic y proyectarse luego
+* en memoria de solo lectura, compartiendo las páginas entre procesos.
+*/
+class DictionaryMatcher
+{
+    private:
+
+        /** Cabecera de la imagen binaria del autómata. */
+        struct Header
+        {
+            char magic[8];
+            quint32 version;
+            quint32 byteOrder;
+            DictionarySource source;
+            qint32 nodeCount;
+            qint32 edgeCount;
+            qint32 maxLength;
+            qint32 wordCount;
+            qint64 nodesOffset;
+            qint64 edgesOffset;
+        };
+
+        /** Estado del autómata. */
+        struct Node
+        {
+            /** Índice de la primera transición del estado. */
+            qint32 firstEdge;
+
+            /** Cantidad de transiciones del estado. */
+            qint32 edgeCount;
+
+            /** Estado de fallo. */
+            qint32 fail;
+
+            /** Longitud de la palabra que termina en el estado o 0. */
+            qint32 output;
+
+            /**
+            * Siguiente estado en la cadena de fallos que termina una palabra o
+            * -1 si no existe.
+            */
+            qint32 outputLink;
+        };
+
+        /** Transición del autómata. */
+        struct Edge
+        {
+            /** Carácter UTF-16 de la transición. */
+            quint16 symbol;
+
+            /** Relleno para alinear el destino. */
+            quint16 padding;
+
+            /** Estado destino. */
+            qint32 target;
+        };
+
+        /** Imagen del autómata cuando se construye en memoria. */
+        QByteArray image;
+
+        /** Fichero de la imagen cuando se proyecta en memoria. */
+        QFile *mappedFile;
+
+        /** Cabecera de la imagen en uso. */
+        const Header *header;
+
+        /** Estados del autómata, el estado 0 es la raíz. */
+        const Node *nodes;
+
+        /** Transiciones ordenadas por estado y carácter. */
+        const Edge *edges;
+
+        /** Libera la imagen en uso. */
+        void release();
+
+        /**
+        * Establece los punteros a la imagen data de tamaño size, comprobando
+        * que sea correcta.
+        * @return Devuelve true si la imagen es correcta.
+        */
+        bool attach(const uchar *data, qint64 size);
+
+        /**
+        * Comprueba que los índices de los estados y transiciones de la imagen
+        * en uso sean correctos, para no acceder fuera de ella si el fichero
+        * está dañado. Las transiciones deben apuntar a estados posteriores y
+        * los estados de fallo y de salida a estados anteriores, y la longitud
+        * de cada palabra debe ser la profundidad de su estado.
+        * @return Devuelve true si la imagen es consistente.
+        */
+        bool isConsistent() const;
+
+        /**
+        * Retorna el estado alcanzado desde state con el carácter symbol, o -1
+        * si no existe la transición.
+        */
+        int transition(int state, ushort symbol) const;
+
+        /**
+        * Retorna si existe un límite de palabra en la posición pos del texto
+        * referenciado.
+        */
+        static bool isBoundary(const QStringRef &text, int pos);
+
+        DictionaryMatcher(const DictionaryMatcher &);
+        DictionaryMatcher &operator=(const DictionaryMatcher &);
+
+    public:
+
+        /** Constructor, crea un diccionario vacío. */
+        DictionaryMatcher();
+
+        /** Destructor. */
+        ~DictionaryMatcher();
+
+        /**
+        * Construye el autómata en memoria a partir de la lista de palabras.
+        * @param words palabras del diccionario.
+        * @param source identificación del fichero de origen.
+        */
+        void build(QStringList words, DictionarySource source);
+
+        /**
+        * Guarda la imagen del autómata en el fichero path.
+        * @return Devuelve true si se pudo escribir el fichero.
+        */
+        bool save(const QString &path) const;
+
+        /**
+        * Guarda la imagen del autómata en el fichero path con la
+        * identificación de origen source, sin reconstruir el autómata.
+        * @return Devuelve true si se pudo escribir el fichero.
+        */
+        bool save(const QString &path, const DictionarySource &source) const;
+
+        /**
+        * Proyecta en memoria de solo lectura la imagen guardada en el fichero
+        * path.
+        * @return Devuelve true si el fichero contiene una imagen correcta.
+        */
+        bool map(const QString &path);
+
+        /** Retorna la identificación del fichero de origen del autómata. */
+        DictionarySource source() const;
+
+        /** Retorna si el autómata se proyecta desde un fichero. */
+        bool isMapped() const;
+
+        /** Retorna si el diccionario no contiene palabras. */
+        bool isEmpty() const;
+
+        /** Retorna la cantidad de palabras del diccionario. */
+        int size() const;
+
+        /**
+        * Busca la primera palabra del diccionario dentro de la referencia text.
+        * El texto referenciado se trata como si fuera la entrada completa.
+        * @param text referencia al texto a analizar.
+        * @param matchedLength longitud de la palabra reconocida.
+        * @return Devuelve la posición de la palabra relativa al inicio de la
+        * referencia o -1 si no se encuentra ninguna.
+        */
+        int indexIn(const QStringRef &text, int *matchedLength) const;
+
+        /**
+        * Agrega a first la primera letra de cada palabra del diccionario.
+        * @param first conjunto donde se agregan los caracteres.
+        */
+        void firstChars(CharSet *first) const;
+};
+
+#endif // DICTIONARYMATCHER_H
@@ -0,0 +1,39 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <domsink.h>
+#include <astnode.h>
+
+DomSink::DomSink(QDomDocument doc) {
+    this->document = doc;
+}
+
+void DomSink::begin() {
+    if (document.documentElement().isNull()) {
+        document.appendChild(document.createElement(ROOT_TAG));
+    }
+}
+
+void DomSink::occurrence(const Occurrence &ocur) {
+
+    /* Se crea el elemento de la ocurrencia con el texto de entrada y la
+    estructura del árbol reconocido.*/
+    QDomElement ocurElem = document.createElement(ocur.format);
+    document.documentElement().appendChild(ocurElem);
+    QDomElement frmtInput = document.createElement(INPUT_TAG);
+    frmtInput.appendChild(document.createTextNode(ocur.input.toString()));
+    ocurElem.appendChild(frmtInput);
+    QDomElement frmtOutput = ocur.tree->toDom(&document, ocur.symbols,
+                                              ocur.base());
+    frmtOutput.setAttribute(ATTR_MSECS, milliseconds(ocur.nsecs));
+    ocurElem.appendChild(frmtOutput);
+}
+
+void DomSink::unknown(const QStringRef &text, qint64 offset) {
+    Q_UNUSED(offset);
+    QDomElement unknow = document.createElement(UNKNOWN_TAG);
+    unknow.appendChild(document.createTextNode(text.toString()));
+    document.documentElement().appendChild(unknow);
+}
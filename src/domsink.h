@@ -0,0 +1,47 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef DOMSINK_H
+#define DOMSINK_H
+
+#include <QDomDocument>
+
+#include <outputsink.h>
+
+#define ROOT_TAG "xml"
+#define INPUT_TAG "inputdata"
+#define UNKNOWN_TAG "unknow"
+#define ATTR_MSECS "milisecs"
+
+/**
+* DomSink agrega los resultados del análisis a un documento DOM, con la
+* estructura que devuelve ParserManager::toDom.
+*/
+class DomSink : public OutputSink
+{
+    private:
+
+        /** Documento donde se agregan los resultados. */
+        QDomDocument document;
+
+    public:
+
+        /**
+        * Constructor.
+        * @param doc documento donde se agregan los resultados.
+        */
+        DomSink(QDomDocument doc);
+
+        /** Crea el elemento raíz del documento si no existe. */
+        void begin();
+
+        /** Agrega al documento el elemento de la ocurrencia ocur. */
+        void occurrence(const Occurrence &ocur);
+
+        /** Agrega al documento un elemento con el texto no reconocido. */
+        void unknown(const QStringRef &text, qint64 offset);
+};
+
+#endif // DOMSINK_H
@@ -0,0 +1,118 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <formatscanner.h>
+
+void FormatScanner::addFormat(const Matcher &matcher,
+                              const QString &delimiter) {
+    Candidate candidate;
+    candidate.matcher = matcher;
+    candidate.delimiter = delimiter;
+    candidate.position = -2;
+    candidate.length = 0;
+
+    if (matcher.isEmpty() || !matcher.isValid()) {
+        candidate.position = -1;
+    }
+    candidates.append(candidate);
+}
+
+int FormatScanner::next(const QString &input, int from, int *format,
+                        int *length) {
+    int minpos = -1;
+    int majlength = 0;
+
+    for (int i = 0; i < candidates.size(); ++i) {
+        Candidate &candidate = candidates[i];
+
+        /* Solo se busca de nuevo si la coincidencia almacenada comienza antes
+        de la posición actual. Un formato que no aparece más no se vuelve a
+        buscar.*/
+        if (candidate.position == -2 ||
+                (candidate.position >= 0 && candidate.position < from)) {
+            candidate.position = search(candidate, input, from);
+
+            /* Las coincidencias vacías no se reportan, ya que no hacen avanzar
+            la búsqueda; se busca de nuevo a partir de la posición siguiente.*/
+            while (candidate.position >= 0 && candidate.length == 0) {
+                if (candidate.position >= input.length()) {
+                    candidate.position = -1;
+                    break;
+                }
+                candidate.position = search(candidate, input,
+                                            candidate.position + 1);
+            }
+        }
+        if (candidate.position < 0) {
+            continue;
+        }
+
+        if (minpos == -1 || candidate.position < minpos ||
+                (candidate.position == minpos && candidate.length > majlength)) {
+            *format = i;
+            minpos = candidate.position;
+            majlength = candidate.length;
+        }
+    }
+
+    *length = majlength;
+    return minpos;
+}
+
+int FormatScanner::search(Candidate &candidate, const QString &input,
+                          int from) {
+    candidate.length = 0;
+    if (candidate.delimiter.isEmpty()) {
+        return candidate.matcher.indexIn(input, from, &candidate.length);
+    }
+    return findRecord(candidate.matcher, candidate.delimiter, input, from,
+                      &candidate.length);
+}
+
+int FormatScanner::recordStart(const QString &delimiter, const QString &input,
+                               int from) {
+    if (from < delimiter.length()) {
+        return 0;
+    }
+    int begin = delimiter.length() == 1 ?
+                input.lastIndexOf(delimiter.at(0), from - 1) :
+                input.lastIndexOf(delimiter, from - delimiter.length());
+    return begin == -1 ? 0 : begin + delimiter.length();
+}
+
+int FormatScanner::findRecord(const Matcher &matcher, const QString &delimiter,
+                              const QString &input, int from, int *length,
+                              bool *partial) {
+    if (partial) {
+        *partial = false;
+    }
+    int begin = recordStart(delimiter, input, from);
+
+    while (from < input.length()) {
+        int end = delimiter.length() == 1 ?
+                    input.indexOf(delimiter.at(0), from) :
+                    input.indexOf(delimiter, from);
+
+        /* Mientras la entrada puede continuar, el último registro aún no
+        está completo y una ocurrencia puede comenzar en él.*/
+        if (end == -1 && partial) {
+            *partial = true;
+            *length = 0;
+            return from;
+        }
+        end = end == -1 ? input.length() : end + delimiter.length();
+
+        int n = 0;
+        QStringRef record(&input, begin, end - begin);
+        int pos = matcher.indexIn(record, from - begin, &n);
+        if (pos != -1 && n > 0) {
+            *length = n;
+            return begin + pos;
+        }
+        from = end;
+        begin = end;
+    }
+    return -1;
+}
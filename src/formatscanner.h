@@ -0,0 +1,117 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef FORMATSCANNER_H
+#define FORMATSCANNER_H
+
+#include <QString>
+#include <QVector>
+
+#include <matcher.h>
+
+/**
+* FormatScanner busca en un solo recorrido de la entrada las ocurrencias de
+* varios formatos, devolviendo en cada paso la ocurrencia más a la izquierda
+* y, entre las que comienzan en la misma posición, la más larga. Las
+* coincidencias vacías se descartan. Los formatos orientados a registros se
+* buscan dentro de cada registro, igual que en ParserManager::parseFormat.
+*
+* La siguiente coincidencia de cada formato se conserva entre llamadas y solo
+* se vuelve a buscar cuando la búsqueda avanza más allá de su inicio. Como
+* ninguna coincidencia del formato comienza antes de la almacenada, buscar
+* desde una posición posterior devuelve la misma coincidencia.
+*/
+class FormatScanner
+{
+    private:
+
+        /** Coincidencia almacenada de un formato. */
+        struct Candidate
+        {
+            /** Reconocedor del formato. */
+            Matcher matcher;
+
+            /** Separador de registros del formato, o vacío. */
+            QString delimiter;
+
+            /**
+            * Posición de la coincidencia, -1 si el formato no aparece más en
+            * la entrada y -2 si aún no se ha buscado.
+            */
+            int position;
+
+            /** Longitud de la coincidencia. */
+            int length;
+        };
+
+        /** Coincidencias de cada formato, en el orden en que se agregaron. */
+        QVector<Candidate> candidates;
+
+        /**
+        * Busca la primera coincidencia del formato de candidate en input a
+        * partir de from, estableciendo su longitud.
+        * @return Devuelve la posición de la coincidencia o -1 si no existe.
+        */
+        static int search(Candidate &candidate, const QString &input, int from);
+
+    public:
+
+        /**
+        * Agrega un formato al reconocedor. Los formatos sin expresión
+        * regular válida nunca se reportan.
+        * @param matcher reconocedor de las ocurrencias del formato.
+        * @param delimiter separador de registros del formato, o vacío si sus
+        * ocurrencias se buscan en toda la entrada.
+        */
+        void addFormat(const Matcher &matcher,
+                       const QString &delimiter = QString());
+
+        /**
+        * Busca la siguiente ocurrencia de algún formato en input a partir de
+        * la posición from. Las llamadas sucesivas sobre la misma entrada
+        * deben usar posiciones no decrecientes.
+        * @param input texto analizado.
+        * @param from posición inicial de la búsqueda.
+        * @param format índice del formato reconocido.
+        * @param length longitud de la ocurrencia.
+        * @return Devuelve la posición de la ocurrencia o -1 si no existe.
+        */
+        int next(const QString &input, int from, int *format, int *length);
+
+        /**
+        * Retorna el inicio del registro de input terminado en delimiter que
+        * contiene la posición from, justo después del último separador que
+        * termina antes de ella, o 0 si no existe.
+        */
+        static int recordStart(const QString &delimiter, const QString &input,
+                               int from);
+
+        /**
+        * Busca la siguiente ocurrencia de un formato orientado a registros a
+        * partir de la posición from. La entrada se divide en registros
+        * terminados en delimiter, que se localizan con la búsqueda
+        * vectorizada de QString, y la expresión del formato se evalúa solo
+        * dentro de cada registro, incluido su separador. Si from está dentro
+        * de un registro, como tras una ocurrencia que no lo abarca completo,
+        * el resto se busca como parte del mismo registro, de forma que "^"
+        * siga coincidiendo solo con su inicio.
+        * @param matcher reconocedor del formato.
+        * @param delimiter separador de registros.
+        * @param input texto analizado.
+        * @param from posición inicial de la búsqueda.
+        * @param length longitud de la ocurrencia encontrada.
+        * @param partial si no es NULL, la entrada puede continuar: el último
+        * registro, sin separador, aún no está completo y no se analiza. Si no
+        * hay ocurrencias en los registros completos se indica en partial que
+        * la ocurrencia puede comenzar en ese registro.
+        * @return Devuelve la posición de la ocurrencia, la posición desde la
+        * que aún puede comenzar si es parcial, o -1 si no existe.
+        */
+        static int findRecord(const Matcher &matcher, const QString &delimiter,
+                              const QString &input, int from, int *length,
+                              bool *partial = NULL);
+};
+
+#endif // FORMATSCANNER_H
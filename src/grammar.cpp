@@ -0,0 +1,346 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <QDebug>
+
+#include <grammar.h>
+
+Grammar::Grammar() {
+    this->format = DEFAULT_FORMAT;
+    this->start = -1;
+}
+
+void Grammar::compile(QDomElement rules) {
+    this->rules.clear();
+    this->symbols.clear();
+    this->productions.clear();
+    this->unanalysed.clear();
+    this->start = -1;
+    this->format = rules.attribute(ATTR_NAME, DEFAULT_FORMAT);
+
+    /* Los formatos orientados a registros definen su separador.*/
+    this->delimiter = rules.attribute(ATTR_RECORD);
+    if (delimiter == RECORD_LINE) {
+        this->delimiter = "\n";
+    }
+
+    /* Se compilan las producciones de primer nivel en el orden en que fueron
+    definidas y se agrupan por etiqueta para resolver las referencias.*/
+    QDomElement cursor = rules.firstChildElement();
+    while (!cursor.isNull()) {
+        int index = compileRule(cursor);
+        productions[cursor.tagName()].append(index);
+        if (start == -1 && cursor.tagName() == format) {
+            start = index;
+        }
+        cursor = cursor.nextSiblingElement();
+    }
+
+    if (start == -1) {
+        qCritical() << "Parser: No se pudo encontrar el elemento inicial de "
+                       "la gramatica del formato " << format;
+    }
+
+    /* Se resuelven los destinos de cada referencia.*/
+    for (int i = 0; i < this->rules.size(); ++i) {
+        Rule &rule = this->rules[i];
+        if (rule.ruleClass != RULE_REFERENCE) {
+            continue;
+        }
+        rule.targets = productions.value(rule.tagName);
+        if (rule.targets.isEmpty()) {
+            qCritical() << "Parser: No se pudo encontrar el elemento" <<
+                           rule.tagName;
+        }
+    }
+
+    computeFirstSets();
+}
+
+void Grammar::computeFirstSets() {
+
+    /* Los terminales y no terminales comienzan con el primer carácter del
+    texto reconocido por su expresión regular, y los terminales de
+    diccionario con la primera letra de alguna palabra. Las reglas sin
+    expresión válida o de clase desconocida nunca producen un resultado.*/
+    for (int i = 0; i < rules.size(); ++i) {
+        Rule &rule = rules[i];
+        rule.anchored = rule.ruleClass != RULE_LIST &&
+                rule.ruleClass != RULE_COLLECTION;
+        if (rule.ruleClass == RULE_INITIAL ||
+                rule.ruleClass == RULE_NON_TERMINAL ||
+                rule.ruleClass == RULE_REG_TERMINAL) {
+            if (rule.matcher.isValid() &&
+                    !rule.matcher.firstChars(&rule.first)) {
+                rule.first = CharSet::full();
+                unanalysed.append(i);
+            }
+        } else if (rule.ruleClass == RULE_DIC_TERMINAL) {
+            rule.firstDictionaries.append(rule.tagName);
+        }
+    }
+
+    /* Una lista comienza con su elemento y el resto de las reglas compuestas
+    con cualquiera de sus hijos o producciones. Los no terminales no se
+    incluyen, ya que su texto es el reconocido por su propia expresión.*/
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < rules.size(); ++i) {
+            Rule &rule = rules[i];
+            QVector<int> sources;
+            if (rule.ruleClass == RULE_REFERENCE) {
+                sources = rule.targets;
+            } else if (rule.ruleClass == RULE_LIST) {
+                sources = rule.children.mid(0, 1);
+            } else if (rule.ruleClass == RULE_OPTION ||
+                       rule.ruleClass == RULE_COLLECTION) {
+                sources = rule.children;
+            }
+
+            for (int j = 0; j < sources.size(); ++j) {
+                const Rule &source = rules.at(sources.at(j));
+                if (rule.first.unite(source.first)) {
+                    changed = true;
+                }
+                for (int k = 0; k < source.firstDictionaries.size(); ++k) {
+                    const QString &name = source.firstDictionaries.at(k);
+                    if (!rule.firstDictionaries.contains(name)) {
+                        rule.firstDictionaries.append(name);
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    /* Una referencia u opción devuelve el nodo de alguna de sus producciones
+    u opciones, por lo que comienza en el primer carácter reconocido solo si
+    todas ellas lo hacen.*/
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < rules.size(); ++i) {
+            Rule &rule = rules[i];
+            if (!rule.anchored) {
+                continue;
+            }
+            QVector<int> sources;
+            if (rule.ruleClass == RULE_REFERENCE) {
+                sources = rule.targets;
+            } else if (rule.ruleClass == RULE_OPTION) {
+                sources = rule.children;
+            }
+            for (int j = 0; j < sources.size(); ++j) {
+                if (!rules.at(sources.at(j)).anchored) {
+                    rule.anchored = false;
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int Grammar::compileRule(QDomElement elem) {
+    Rule rule;
+    rule.tagName = elem.tagName();
+    rule.varName = elem.attribute(ATTR_NAME);
+    rule.required = elem.attribute(ATTR_REQUIRED) != REQUIRED_FALSE;
+
+    /* Se identifica la clase de la regla.*/
+    QString className = elem.attribute(ATTR_CLASS);
+    if (className.isEmpty()) {
+        qCritical() << "Parser: No se ha definido el atributo " ATTR_CLASS
+                       " para el elemento" << rule.tagName;
+        rule.ruleClass = RULE_UNDEFINED;
+    } else if (className == CLASS_INITIAL) {
+        rule.ruleClass = RULE_INITIAL;
+    } else if (className == CLASS_NON_TERMINAL) {
+        rule.ruleClass = RULE_NON_TERMINAL;
+    } else if (className == CLASS_REG_TERMINAL) {
+        rule.ruleClass = RULE_REG_TERMINAL;
+    } else if (className == CLASS_DIC_TERMINAL) {
+        rule.ruleClass = RULE_DIC_TERMINAL;
+    } else if (className == CLASS_REFERENCE) {
+        rule.ruleClass = RULE_REFERENCE;
+    } else if (className == CLASS_OPTION) {
+        rule.ruleClass = RULE_OPTION;
+    } else if (className == CLASS_LIST) {
+        rule.ruleClass = RULE_LIST;
+    } else if (className == CLASS_COLLECTION) {
+        rule.ruleClass = RULE_COLLECTION;
+    } else {
+        qCritical() << "Parser: No se pudo reconocer la clase" << className;
+        rule.ruleClass = RULE_UNKNOWN;
+    }
+
+    /* Los nodos de la producción inicial de la gramática se etiquetan como
+    "output".*/
+    bool isProduction = rule.ruleClass == RULE_INITIAL ||
+            rule.ruleClass == RULE_NON_TERMINAL;
+    rule.nodeTag = symbols.intern(isProduction && rule.tagName == format ?
+                                      QString(OUTPUT_TAG) : rule.tagName);
+    rule.varId = rule.varName.isEmpty() ? -1 : symbols.intern(rule.varName);
+
+    /* Se precompila la expresión regular de los terminales y no terminales.*/
+    if (rule.ruleClass == RULE_INITIAL || rule.ruleClass == RULE_NON_TERMINAL ||
+            rule.ruleClass == RULE_REG_TERMINAL) {
+        QString regexpStr = elem.attribute(ATTR_REGEXP);
+        if (regexpStr.isEmpty()) {
+            qCritical() << "Parser: No se ha definido el atributo " ATTR_REGEXP
+                           " para el elemento" << rule.tagName;
+        }
+        rule.matcher = Matcher(regexpStr);
+        if (!rule.matcher.isValid()) {
+            qCritical() << "Parser: La expresion regular para el elemento" <<
+                           rule.tagName << "no es correcta:" <<
+                           rule.matcher.errorString();
+        }
+    }
+
+    /* Se reserva la posición de la regla antes de compilar sus hijos para que
+    las producciones conserven el orden del documento.*/
+    int index = rules.size();
+    rules.append(rule);
+
+    QVector<int> children;
+    QDomElement cursor = elem.firstChildElement();
+    while (!cursor.isNull()) {
+        children.append(compileRule(cursor));
+        cursor = cursor.nextSiblingElement();
+    }
+
+    if (children.isEmpty() && (rule.ruleClass == RULE_OPTION ||
+                               rule.ruleClass == RULE_LIST ||
+                               rule.ruleClass == RULE_COLLECTION)) {
+        qCritical() << "Parser: No existen hijos para el elemento" <<
+                       rule.tagName;
+    }
+
+    rules[index].children = children;
+    return index;
+}
+
+QString Grammar::getFormat() const {
+    return this->format;
+}
+
+int Grammar::startRule() const {
+    return this->start;
+}
+
+QString Grammar::recordDelimiter() const {
+    return this->delimiter;
+}
+
+const SymbolTable &Grammar::symbolTable() const {
+    return this->symbols;
+}
+
+int Grammar::ruleCount() const {
+    return this->rules.size();
+}
+
+const Rule &Grammar::rule(int index) const {
+    return this->rules.at(index);
+}
+
+Projection Grammar::project(const QStringList &names) const {
+    if (names.isEmpty()) {
+        return Projection();
+    }
+
+    QVector<bool> requested(symbols.size(), false);
+    for (int i = 0; i < names.size(); ++i) {
+        int id = symbols.id(names.at(i));
+        if (id != -1) {
+            requested[id] = true;
+        }
+    }
+
+    /* Para cada regla se calcula si la raíz de su resultado y si alguno de
+    sus descendientes pueden tener un nombre solicitado. Las referencias y
+    opciones devuelven el nodo de la regla elegida, renombrándolo si definen
+    una variable. Como la gramática puede ser recursiva, se itera hasta que
+    no hay cambios.*/
+    QVector<bool> rootHit(rules.size(), false);
+    QVector<bool> innerHit(rules.size(), false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = 0; i < rules.size(); ++i) {
+            const Rule &rule = rules.at(i);
+            bool root = false;
+            bool inner = false;
+
+            if (rule.ruleClass == RULE_REFERENCE ||
+                    rule.ruleClass == RULE_OPTION) {
+                const QVector<int> &alternatives =
+                        rule.ruleClass == RULE_REFERENCE ?
+                            rule.targets : rule.children;
+                if (rule.varId != -1) {
+                    root = requested.at(rule.varId);
+                }
+                for (int j = 0; j < alternatives.size(); ++j) {
+                    int alt = alternatives.at(j);
+                    if (rule.varId == -1) {
+                        root = root || rootHit.at(alt);
+                    }
+                    inner = inner || innerHit.at(alt);
+                }
+            } else {
+                root = requested.at(rule.varId != -1 ? rule.varId :
+                                                       rule.nodeTag);
+                for (int j = 0; j < rule.children.size(); ++j) {
+                    int child = rule.children.at(j);
+                    inner = inner || rootHit.at(child) || innerHit.at(child);
+                }
+            }
+
+            if (root != rootHit.at(i) || inner != innerHit.at(i)) {
+                rootHit[i] = root;
+                innerHit[i] = inner;
+                changed = true;
+            }
+        }
+    }
+
+    return Projection(requested, innerHit);
+}
+
+QStringList Grammar::unanalysedRules() const {
+    QStringList result;
+    for (int i = 0; i < unanalysed.size(); ++i) {
+        const Rule &rule = rules.at(unanalysed.at(i));
+        result.append(QString("%1 (%2): %3").arg(rule.tagName,
+                                                 className(rule.ruleClass),
+                                                 rule.matcher.pattern()));
+    }
+    return result;
+}
+
+QString Grammar::className(RuleClass ruleClass) {
+    switch (ruleClass) {
+    case RULE_INITIAL:
+        return CLASS_INITIAL;
+    case RULE_NON_TERMINAL:
+        return CLASS_NON_TERMINAL;
+    case RULE_REG_TERMINAL:
+        return CLASS_REG_TERMINAL;
+    case RULE_DIC_TERMINAL:
+        return CLASS_DIC_TERMINAL;
+    case RULE_REFERENCE:
+        return CLASS_REFERENCE;
+    case RULE_OPTION:
+        return CLASS_OPTION;
+    case RULE_LIST:
+        return CLASS_LIST;
+    case RULE_COLLECTION:
+        return CLASS_COLLECTION;
+    default:
+        return QString();
+    }
+}
@@ -0,0 +1,230 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <QDomElement>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+#include <matcher.h>
+#include <charset.h>
+#include <symboltable.h>
+#include <projection.h>
+
+#define DEFAULT_FORMAT "default"
+
+#define ATTR_CLASS "class"
+#define ATTR_REGEXP "regexp"
+#define ATTR_NAME "name"
+#define ATTR_TYPE "type"
+#define ATTR_REQUIRED "required"
+#define ATTR_RECORD "record"
+
+#define CLASS_INITIAL "initial"
+#define CLASS_REFERENCE "reference"
+#define CLASS_NON_TERMINAL "non_terminal"
+#define CLASS_REG_TERMINAL "reg_terminal"
+#define CLASS_DIC_TERMINAL "dic_terminal"
+#define CLASS_OPTION "option"
+#define CLASS_LIST "list"
+#define CLASS_COLLECTION "collection"
+
+#define REQUIRED_FALSE "false"
+#define REQUIRED_TRUE "true"
+
+#define RECORD_LINE "line"
+
+#define OUTPUT_TAG "output"
+
+/** Clases de reglas sintácticas que reconoce el analizador. */
+enum RuleClass {
+    RULE_UNDEFINED,
+    RULE_UNKNOWN,
+    RULE_INITIAL,
+    RULE_NON_TERMINAL,
+    RULE_REG_TERMINAL,
+    RULE_DIC_TERMINAL,
+    RULE_REFERENCE,
+    RULE_OPTION,
+    RULE_LIST,
+    RULE_COLLECTION
+};
+
+/**
+* Rule representa una regla sintáctica ya compilada. Todos los atributos que
+* antes se leían del elemento DOM en cada llamada quedan resueltos al cargar la
+* gramática.
+*/
+struct Rule
+{
+    /** Clase de la regla. */
+    RuleClass ruleClass;
+
+    /** Etiqueta del elemento que define la regla. */
+    QString tagName;
+
+    /** Nombre de variable definido para la regla. */
+    QString varName;
+
+    /** Identificador de la etiqueta con la que se crean los nodos del árbol. */
+    int nodeTag;
+
+    /**
+    * Identificador del nombre de variable definido para la regla o -1 si no se
+    * ha definido.
+    */
+    int varId;
+
+    /** Indica si la aparición de la regla es obligatoria. */
+    bool required;
+
+    /** Expresión regular precompilada de la regla. */
+    Matcher matcher;
+
+    /** Índices de las reglas hijas en el orden en que fueron definidas. */
+    QVector<int> children;
+
+    /**
+    * Índices de las producciones con igual etiqueta que una referencia, en el
+    * orden en que aparecen en la gramática.
+    */
+    QVector<int> targets;
+
+    /**
+    * Caracteres con que puede comenzar el texto de un resultado no vacío de
+    * la regla, sin contar los de los diccionarios.
+    */
+    CharSet first;
+
+    /**
+    * Diccionarios cuyas palabras pueden iniciar el texto de un resultado de
+    * la regla.
+    */
+    QStringList firstDictionaries;
+
+    /**
+    * Indica si el nodo resultante comienza en el primer carácter reconocido,
+    * por lo que su posición es la de alguno de los caracteres de first. Las
+    * listas y colecciones comienzan donde comienza el texto analizado.
+    */
+    bool anchored;
+};
+
+/**
+* Grammar compila las reglas sintácticas de un formato, definidas en un
+* documento xml, en una tabla de reglas sobre la cual trabaja el analizador. El
+* documento DOM solo se recorre al cargar la gramática.
+*/
+class Grammar
+{
+    private:
+
+        /** Nombre del formato descrito por la gramática. */
+        QString format;
+
+        /** Tabla de reglas compiladas. */
+        QVector<Rule> rules;
+
+        /** Etiquetas y nombres de variable de la gramática. */
+        SymbolTable symbols;
+
+        /**
+        * Índices de las producciones de primer nivel agrupados por etiqueta.
+        */
+        QHash<QString, QVector<int> > productions;
+
+        /** Índice de la producción inicial o -1 si no existe. */
+        int start;
+
+        /**
+        * Separador de los registros de la entrada, o vacío si las ocurrencias
+        * se buscan en toda la entrada.
+        */
+        QString delimiter;
+
+        /**
+        * Índices de las reglas cuya expresión regular no se pudo analizar
+        * para obtener sus primeros caracteres.
+        */
+        QVector<int> unanalysed;
+
+        /**
+        * Compila recursivamente el elemento elem y sus hijos.
+        * @param elem elemento DOM que define la regla.
+        * @return Devuelve el índice de la regla compilada.
+        */
+        int compileRule(QDomElement elem);
+
+        /**
+        * Calcula los primeros caracteres de cada regla y si su nodo comienza
+        * en el primer carácter reconocido. Como la gramática puede ser
+        * recursiva, se itera hasta que no hay cambios.
+        */
+        void computeFirstSets();
+
+    public:
+
+        /** Constructor por defecto. */
+        Grammar();
+
+        /**
+        * Compila las reglas sintácticas definidas en el elemento rules.
+        * @param rules elemento raíz de la configuración del formato.
+        */
+        void compile(QDomElement rules);
+
+        /** Retorna el nombre del formato. */
+        QString getFormat() const;
+
+        /** Retorna el índice de la producción inicial o -1 si no existe. */
+        int startRule() const;
+
+        /**
+        * Retorna el separador de registros definido con el atributo record
+        * del elemento raíz, o vacío si no se definió. El valor "line" equivale
+        * al salto de línea.
+        */
+        QString recordDelimiter() const;
+
+        /** Retorna la tabla de símbolos de la gramática. */
+        const SymbolTable &symbolTable() const;
+
+        /** Retorna la cantidad de reglas compiladas. */
+        int ruleCount() const;
+
+        /**
+        * Retorna la regla de índice index.
+        * @param index índice de la regla en la tabla.
+        */
+        const Rule &rule(int index) const;
+
+        /**
+        * Calcula la proyección de la gramática sobre las variables de nombre
+        * names, determinando qué reglas pueden producir alguna de ellas.
+        * @param names nombres de las variables solicitadas.
+        * @return Devuelve la proyección, inactiva si names está vacía.
+        */
+        Projection project(const QStringList &names) const;
+
+        /**
+        * Retorna el valor del atributo class que corresponde a la clase de
+        * regla ruleClass.
+        */
+        static QString className(RuleClass ruleClass);
+
+        /**
+        * Retorna una descripción de las reglas cuyos primeros caracteres no se
+        * pudieron determinar, con su etiqueta, clase y expresión regular. Se
+        * considera que estas reglas pueden comenzar con cualquier carácter,
+        * por lo que el analizador nunca las descarta.
+        */
+        QStringList unanalysedRules() const;
+};
+
+#endif // GRAMMAR_H
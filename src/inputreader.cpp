@@ -0,0 +1,33 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <inputreader.h>
+
+InputReader::~InputReader() {
+}
+
+qint64 InputReader::startByte() const {
+    return 0;
+}
+
+qint64 InputReader::utf8Length(const QStringRef &text) {
+    qint64 length = text.length();
+    const QChar *chars = text.unicode();
+
+    /* Cada caracter ocupa al menos un byte; se suman los bytes adicionales de
+    los que no son ASCII. Un par sustituto ocupa cuatro bytes en total.*/
+    for (int i = 0; i < text.length(); ++i) {
+        ushort c = chars[i].unicode();
+        if (c < 0x80) {
+            continue;
+        }
+        if (c < 0x800 || QChar::isSurrogate(c)) {
+            length += 1;
+        } else {
+            length += 2;
+        }
+    }
+    return length;
+}
@@ -0,0 +1,49 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef INPUTREADER_H
+#define INPUTREADER_H
+
+#include <QString>
+#include <QStringRef>
+
+/**
+* InputReader entrega por bloques el texto de una entrada que se analiza como
+* flujo, de forma que nunca se necesita tenerla completa en memoria.
+*/
+class InputReader
+{
+    public:
+
+        /** Destructor. */
+        virtual ~InputReader();
+
+        /**
+        * Lee el siguiente bloque de texto. Un caracter nunca se divide entre
+        * dos bloques.
+        * @param maxChars cantidad máxima de caracteres a leer.
+        * @return Devuelve el texto leído.
+        */
+        virtual QString read(int maxChars) = 0;
+
+        /** Retorna si se ha leído toda la entrada. */
+        virtual bool atEnd() const = 0;
+
+        /**
+        * Retorna la posición en bytes del primer caracter del texto, que es
+        * distinta de 0 cuando la entrada comienza con una marca de orden de
+        * bytes que no se entrega como texto.
+        */
+        virtual qint64 startByte() const;
+
+        /**
+        * Calcula la cantidad de bytes que ocupa text codificado en UTF-8.
+        * @param text texto a medir.
+        * @return Devuelve la longitud en bytes.
+        */
+        static qint64 utf8Length(const QStringRef &text);
+};
+
+#endif // INPUTREADER_H
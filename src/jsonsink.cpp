@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <jsonsink.h>
+#include <astnode.h>
+#include <symboltable.h>
+
+JsonSink::JsonSink(QIODevice *device) {
+    this->device = device;
+    this->line.reserve(JSON_LINE_CAPACITY);
+}
+
+void JsonSink::appendString(const QStringRef &text) {
+    static const char hex[] = "0123456789abcdef";
+
+    /* Se escapan las comillas, la barra invertida y los caracteres de
+    control; el resto se codifica en UTF-8.*/
+    line.append('"');
+    int begin = 0;
+    for (int i = 0; i < text.length(); ++i) {
+        ushort c = text.at(i).unicode();
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        line.append(QStringRef(text.string(), text.position() + begin,
+                               i - begin).toUtf8());
+        begin = i + 1;
+        switch (c) {
+        case '"': line.append("\\\""); break;
+        case '\\': line.append("\\\\"); break;
+        case '\n': line.append("\\n"); break;
+        case '\r': line.append("\\r"); break;
+        case '\t': line.append("\\t"); break;
+        default:
+            line.append("\\u00");
+            line.append(hex[c >> 4]);
+            line.append(hex[c & 0xF]);
+        }
+    }
+    line.append(QStringRef(text.string(), text.position() + begin,
+                           text.length() - begin).toUtf8());
+    line.append('"');
+}
+
+void JsonSink::appendNode(AstNode *node, const SymbolTable *symbols,
+                          qint64 base) {
+    QStringRef textRef = node->getReference();
+
+    line.append("{\"tag\":");
+    QString tag = symbols->name(node->getTagName());
+    appendString(QStringRef(&tag));
+    line.append(",\"position\":");
+    line.append(QByteArray::number(base + textRef.position()));
+    line.append(",\"length\":");
+    line.append(QByteArray::number(textRef.length()));
+    if (node->getName() != node->getTagName()) {
+        line.append(",\"name\":");
+        QString name = symbols->name(node->getName());
+        appendString(QStringRef(&name));
+    }
+
+    /* Si el nodo no tiene elementos hijos se agrega el texto referenciado,
+    de lo contrario se agrega cada uno de los hijos.*/
+    if (node->childCount() == 0) {
+        line.append(",\"text\":");
+        appendString(textRef);
+    } else {
+        line.append(",\"children\":[");
+        for (AstNode *child = node->getFirstChild(); child;
+             child = child->getNextSibling()) {
+            if (child != node->getFirstChild()) {
+                line.append(',');
+            }
+            appendNode(child, symbols, base);
+        }
+        line.append(']');
+    }
+    line.append('}');
+}
+
+void JsonSink::occurrence(const Occurrence &ocur) {
+    line.resize(0);
+    line.append("{\"format\":");
+    appendString(QStringRef(&ocur.format));
+    line.append(",\"offset\":");
+    line.append(QByteArray::number(ocur.offset));
+    line.append(",\"byteOffset\":");
+    line.append(QByteArray::number(ocur.byteOffset));
+    line.append(",\"milisecs\":");
+    line.append(milliseconds(ocur.nsecs).toLatin1());
+    line.append(",\"input\":");
+    appendString(ocur.input);
+    line.append(",\"output\":");
+    appendNode(ocur.tree, ocur.symbols, ocur.base());
+    line.append("}\n");
+    device->write(line);
+}
+
+void JsonSink::unknown(const QStringRef &text, qint64 offset) {
+    line.resize(0);
+    line.append("{\"unknow\":");
+    appendString(text);
+    line.append(",\"offset\":");
+    line.append(QByteArray::number(offset));
+    line.append("}\n");
+    device->write(line);
+}
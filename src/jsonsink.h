@@ -0,0 +1,66 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef JSONSINK_H
+#define JSONSINK_H
+
+#include <QIODevice>
+#include <QByteArray>
+
+#include <outputsink.h>
+
+#define JSON_LINE_CAPACITY 4096
+
+/**
+* JsonSink escribe los resultados del análisis en formato NDJSON: un objeto
+* JSON por línea para cada ocurrencia o texto no reconocido, a medida que se
+* reconocen.
+*
+* Cada ocurrencia se escribe como
+* {"format":..., "offset":..., "byteOffset":..., "milisecs":..., "input":...,
+* "output":{...}}, donde cada nodo tiene los campos "tag", "position",
+* "length", "name" si es diferente a la etiqueta, y "text" si no tiene hijos o
+* "children" con sus hijos. Las posiciones de los nodos son relativas al
+* inicio de la entrada completa. El texto no reconocido se escribe como
+* {"unknow":..., "offset":...}.
+*/
+class JsonSink : public OutputSink
+{
+    private:
+
+        /** Dispositivo donde se escriben los resultados. */
+        QIODevice *device;
+
+        /**
+        * Línea que se está construyendo. Se vacía sin liberar su memoria, por
+        * lo que solo crece con líneas mayores que las anteriores.
+        */
+        QByteArray line;
+
+        /** Agrega a line el texto text como cadena JSON. */
+        void appendString(const QStringRef &text);
+
+        /**
+        * Agrega a line el objeto del nodo node y sus hijos, sumando base a la
+        * posición de cada nodo.
+        */
+        void appendNode(AstNode *node, const SymbolTable *symbols, qint64 base);
+
+    public:
+
+        /**
+        * Constructor.
+        * @param device dispositivo abierto para escritura.
+        */
+        JsonSink(QIODevice *device);
+
+        /** Escribe la línea de la ocurrencia ocur. */
+        void occurrence(const Occurrence &ocur);
+
+        /** Escribe la línea del texto no reconocido. */
+        void unknown(const QStringRef &text, qint64 offset);
+};
+
+#endif // JSONSINK_H
@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <QtAlgorithms>
+#include <qmath.h>
+
+#include <latencyhistogram.h>
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+int LatencyHistogram::bucketIndex(quint64 value) {
+    if (value < HISTOGRAM_SUB_COUNT) {
+        return int(value);
+    }
+
+    /* Los valores mayores se ubican según su bit más significativo y los
+    HISTOGRAM_SUB_BITS bits siguientes.*/
+    int shift = 63 - qCountLeadingZeroBits(value) - HISTOGRAM_SUB_BITS;
+    return ((shift + 1) << HISTOGRAM_SUB_BITS) +
+            int((value >> shift) - HISTOGRAM_SUB_COUNT);
+}
+
+qint64 LatencyHistogram::bucketValue(int index) {
+    if (index < HISTOGRAM_SUB_COUNT) {
+        return index;
+    }
+
+    int shift = (index >> HISTOGRAM_SUB_BITS) - 1;
+    quint64 sub = quint64(index & (HISTOGRAM_SUB_COUNT - 1)) +
+            HISTOGRAM_SUB_COUNT;
+    return qint64(((sub + 1) << shift) - 1);
+}
+
+void LatencyHistogram::record(qint64 nsecs, qint64 processed) {
+    nsecs = qMax(Q_INT64_C(0), nsecs);
+    counts[bucketIndex(quint64(nsecs))].fetchAndAddRelaxed(1);
+    total.fetchAndAddRelaxed(1);
+    bytes.fetchAndAddRelaxed(processed);
+    sum.fetchAndAddRelaxed(nsecs);
+
+    qint64 current = maximum.load();
+    while (nsecs > current && !maximum.testAndSetRelaxed(current, nsecs)) {
+        current = maximum.load();
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        counts[i].store(0);
+    }
+    total.store(0);
+    bytes.store(0);
+    sum.store(0);
+    maximum.store(0);
+}
+
+qint64 LatencyHistogram::percentile(double quantile) const {
+    qint64 count = total.load();
+    if (count == 0) {
+        return 0;
+    }
+
+    /* Se busca el primer intervalo donde la cantidad acumulada alcanza la
+    proporción solicitada.*/
+    qint64 target = qMax(Q_INT64_C(1), qint64(qCeil(quantile * count)));
+    qint64 accumulated = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        accumulated += counts[i].load();
+        if (accumulated >= target) {
+            return qMin(bucketValue(i), maximum.load());
+        }
+    }
+    return maximum.load();
+}
+
+FormatStats LatencyHistogram::stats(const QString &format) const {
+    FormatStats result;
+    result.format = format;
+    result.count = total.load();
+    result.bytes = bytes.load();
+    result.totalNsecs = sum.load();
+    result.p50 = percentile(0.5);
+    result.p99 = percentile(0.99);
+    result.p999 = percentile(0.999);
+    result.max = maximum.load();
+    return result;
+}
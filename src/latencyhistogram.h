@@ -0,0 +1,107 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QAtomicInteger>
+#include <QString>
+
+#define HISTOGRAM_SUB_BITS 7
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS ((64 - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT)
+
+/**
+* Resumen de los tiempos de análisis de un formato.
+*/
+struct FormatStats
+{
+    /** Nombre del formato. */
+    QString format;
+
+    /** Cantidad de ocurrencias analizadas. */
+    qint64 count;
+
+    /** Cantidad de bytes UTF-8 de las ocurrencias analizadas. */
+    qint64 bytes;
+
+    /** Tiempo total en nanosegundos. */
+    qint64 totalNsecs;
+
+    /** Mediana del tiempo por ocurrencia en nanosegundos. */
+    qint64 p50;
+
+    /** Percentil 99 del tiempo por ocurrencia en nanosegundos. */
+    qint64 p99;
+
+    /** Percentil 99,9 del tiempo por ocurrencia en nanosegundos. */
+    qint64 p999;
+
+    /** Mayor tiempo por ocurrencia en nanosegundos. */
+    qint64 max;
+};
+
+/**
+* LatencyHistogram acumula tiempos en nanosegundos en intervalos de tamaño
+* logarítmico, cada uno dividido en HISTOGRAM_SUB_COUNT partes iguales, de
+* forma que los percentiles se obtienen con un error relativo menor que
+* 1/HISTOGRAM_SUB_COUNT y memoria constante.
+*
+* Los contadores son atómicos: se puede registrar desde varios hilos y
+* consultar mientras se analiza.
+*/
+class LatencyHistogram
+{
+    private:
+
+        /** Cantidad de valores de cada intervalo. */
+        QAtomicInteger<qint64> counts[HISTOGRAM_BUCKETS];
+
+        /** Cantidad total de valores. */
+        QAtomicInteger<qint64> total;
+
+        /** Suma de los bytes procesados. */
+        QAtomicInteger<qint64> bytes;
+
+        /** Suma de los valores. */
+        QAtomicInteger<qint64> sum;
+
+        /** Mayor valor registrado. */
+        QAtomicInteger<qint64> maximum;
+
+        /** Retorna el intervalo del valor value. */
+        static int bucketIndex(quint64 value);
+
+        /** Retorna el mayor valor del intervalo index. */
+        static qint64 bucketValue(int index);
+
+        /** Retorna el percentil quantile de los valores registrados. */
+        qint64 percentile(double quantile) const;
+
+        Q_DISABLE_COPY(LatencyHistogram)
+
+    public:
+
+        /** Constructor, crea un histograma vacío. */
+        LatencyHistogram();
+
+        /**
+        * Registra un análisis.
+        * @param nsecs tiempo del análisis en nanosegundos.
+        * @param processed cantidad de bytes analizados.
+        */
+        void record(qint64 nsecs, qint64 processed);
+
+        /** Elimina todos los valores registrados. */
+        void reset();
+
+        /**
+        * Retorna el resumen de los valores registrados.
+        * @param format nombre del formato al que corresponden.
+        */
+        FormatStats stats(const QString &format) const;
+};
+
+#endif // LATENCYHISTOGRAM_H
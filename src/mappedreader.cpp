@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <mappedreader.h>
+
+MappedReader::MappedReader(const QString &path) : file(path) {
+    this->data = NULL;
+    this->size = 0;
+    this->position = 0;
+    this->bomLength = 0;
+}
+
+MappedReader::~MappedReader() {
+    if (data) {
+        file.unmap(const_cast<uchar *>(data));
+    }
+    file.close();
+}
+
+bool MappedReader::map() {
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    /* Un fichero vacío no se puede proyectar, pero se lee como una entrada
+    sin texto.*/
+    size = file.size();
+    if (size == 0) {
+        return true;
+    }
+
+    data = file.map(0, size);
+    if (!data) {
+        file.close();
+        size = 0;
+        return false;
+    }
+
+    /* Se omite la marca de orden de bytes, igual que al leer con
+    QTextStream.*/
+    if (size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+        bomLength = 3;
+        position = bomLength;
+    }
+    return true;
+}
+
+int MappedReader::boundary(int length) const {
+    if (position + length >= size) {
+        return int(size - position);
+    }
+
+    /* Si el bloque termina dentro de un caracter multibyte, se corta antes del
+    byte inicial de ese caracter.*/
+    const uchar *block = data + position;
+    int end = length;
+    while (end > 0 && (block[end] & 0xC0) == 0x80) {
+        end--;
+    }
+    return end > 0 ? end : length;
+}
+
+QString MappedReader::read(int maxChars) {
+    if (atEnd()) {
+        return QString();
+    }
+
+    /* Cada caracter ocupa al menos un byte, por lo que un bloque de maxChars
+    bytes nunca produce más de maxChars caracteres.*/
+    int length = boundary(maxChars);
+    const char *block = reinterpret_cast<const char *>(data + position);
+    position += length;
+    return QString::fromUtf8(block, length);
+}
+
+bool MappedReader::atEnd() const {
+    return position >= size;
+}
+
+qint64 MappedReader::startByte() const {
+    return bomLength;
+}
@@ -0,0 +1,70 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef MAPPEDREADER_H
+#define MAPPEDREADER_H
+
+#include <QFile>
+
+#include <inputreader.h>
+
+/**
+* MappedReader lee un fichero de texto UTF-8 proyectándolo en memoria. El
+* contenido se decodifica por bloques a medida que se lee, por lo que nunca se
+* mantiene una copia completa en UTF-16.
+*/
+class MappedReader : public InputReader
+{
+    private:
+
+        /** Fichero proyectado. */
+        QFile file;
+
+        /** Contenido del fichero. */
+        const uchar *data;
+
+        /** Tamaño del fichero en bytes. */
+        qint64 size;
+
+        /** Posición en bytes del siguiente bloque. */
+        qint64 position;
+
+        /** Longitud en bytes de la marca de orden de bytes omitida. */
+        qint64 bomLength;
+
+        /**
+        * Retorna la longitud de un bloque de hasta length bytes a partir de
+        * position que no divide ningún caracter UTF-8.
+        */
+        int boundary(int length) const;
+
+    public:
+
+        /**
+        * Constructor.
+        * @param path ruta del fichero.
+        */
+        MappedReader(const QString &path);
+
+        /** Destructor, libera la proyección del fichero. */
+        ~MappedReader();
+
+        /**
+        * Proyecta el fichero en memoria.
+        * @return Devuelve false si el fichero no se pudo abrir o proyectar.
+        */
+        bool map();
+
+        /** Lee el siguiente bloque de texto del fichero. */
+        QString read(int maxChars);
+
+        /** Retorna si se ha leído todo el fichero. */
+        bool atEnd() const;
+
+        /** Retorna la longitud de la marca de orden de bytes omitida. */
+        qint64 startByte() const;
+};
+
+#endif // MAPPEDREADER_H
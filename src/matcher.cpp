@@ -0,0 +1,737 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <cstring>
+
+#include <matcher.h>
+
+Matcher::Matcher() {
+    this->literalPrefix = false;
+}
+
+Matcher::Matcher(const QString &pattern, bool minimal) {
+    this->patternStr = pattern;
+    this->literalPrefix = false;
+
+    QRegularExpression::PatternOptions options =
+            QRegularExpression::DotMatchesEverythingOption |
+            QRegularExpression::UseUnicodePropertiesOption;
+    if (minimal) {
+        options |= QRegularExpression::InvertedGreedinessOption;
+    }
+
+    /* Se compila la expresión regular una sola vez y se optimiza para las
+    búsquedas sucesivas.*/
+    this->regexp = QRegularExpression(translate(pattern), options);
+    if (regexp.isValid()) {
+        regexp.optimize();
+        extractLiteral();
+    }
+}
+
+QString Matcher::translate(const QString &pattern) {
+    QString result;
+    result.reserve(pattern.length() + 8);
+
+    bool inClass = false;
+    for (int i = 0; i < pattern.length(); ++i) {
+        QChar c = pattern.at(i);
+
+        /* Los caracteres escapados se copian sin modificar.*/
+        if (c == QLatin1Char('\\') && i + 1 < pattern.length()) {
+            result.append(c);
+            result.append(pattern.at(++i));
+            continue;
+        }
+
+        if (inClass) {
+            if (c == QLatin1Char(']')) {
+                inClass = false;
+            }
+            result.append(c);
+        } else if (c == QLatin1Char('[')) {
+            inClass = true;
+            result.append(c);
+
+            /* Un ']' al inicio de la clase forma parte de ella.*/
+            if (i + 1 < pattern.length() && pattern.at(i + 1) == QLatin1Char('^')) {
+                result.append(pattern.at(++i));
+            }
+            if (i + 1 < pattern.length() && pattern.at(i + 1) == QLatin1Char(']')) {
+                result.append(pattern.at(++i));
+            }
+
+        /* En QRegExp '$' solo coincide con el final del texto.*/
+        } else if (c == QLatin1Char('$')) {
+            result.append(QLatin1String("\\z"));
+        } else {
+            result.append(c);
+        }
+    }
+    return result;
+}
+
+QString Matcher::pattern() const {
+    return this->patternStr;
+}
+
+bool Matcher::isEmpty() const {
+    return patternStr.isEmpty();
+}
+
+bool Matcher::isValid() const {
+    return regexp.isValid();
+}
+
+QString Matcher::errorString() const {
+    return regexp.errorString();
+}
+
+QString Matcher::requiredLiteral() const {
+    return this->literal;
+}
+
+template <typename Subject>
+int Matcher::findLiteral(const Subject &subject, int from) const {
+    const QChar *data = subject.unicode();
+    const QChar *literalData = literal.unicode();
+    int literalLength = literal.length();
+    int last = subject.length() - literalLength;
+
+    while (from <= last) {
+        from = subject.indexOf(literalData[0], from);
+        if (from == -1 || from > last) {
+            return -1;
+        }
+        if (memcmp(data + from + 1, literalData + 1,
+                   (literalLength - 1) * sizeof(QChar)) == 0) {
+            return from;
+        }
+        from++;
+    }
+    return -1;
+}
+
+template <typename Subject>
+QRegularExpressionMatch Matcher::search(const Subject &subject,
+                                        int from) const {
+    if (literal.isEmpty()) {
+        return regexp.match(subject, from);
+    }
+
+    int candidate = findLiteral(subject, from);
+
+    /* Si el texto literal no aparece no puede haber coincidencias. Si no es
+    el inicio de las coincidencias solo sirve para descartar la búsqueda.*/
+    if (candidate == -1) {
+        return QRegularExpressionMatch();
+    }
+    if (!literalPrefix) {
+        return regexp.match(subject, from);
+    }
+
+    /* Toda coincidencia comienza con el texto literal, por lo que la
+    primera es la que comienza en la primera posición candidata donde se
+    reconoce la expresión.*/
+    while (candidate != -1) {
+        QRegularExpressionMatch match = regexp.match(
+                    subject, candidate, QRegularExpression::NormalMatch,
+                    QRegularExpression::AnchoredMatchOption);
+        if (match.hasMatch()) {
+            return match;
+        }
+        candidate = findLiteral(subject, candidate + 1);
+    }
+    return QRegularExpressionMatch();
+}
+
+int Matcher::indexIn(const QStringRef &text, int *matchedLength) const {
+    return indexIn(text, 0, matchedLength);
+}
+
+int Matcher::indexIn(const QStringRef &text, int from,
+                     int *matchedLength) const {
+    QRegularExpressionMatch match = search(text, from);
+    if (!match.hasMatch()) {
+        return -1;
+    }
+
+    /* Las posiciones de la coincidencia se expresan respecto al texto completo
+    al que pertenece la referencia.*/
+    *matchedLength = match.capturedLength();
+    return match.capturedStart() - text.position();
+}
+
+int Matcher::indexIn(const QString &text, int from, int *matchedLength) const {
+    QRegularExpressionMatch match = search(text, from);
+    if (!match.hasMatch()) {
+        return -1;
+    }
+
+    *matchedLength = match.capturedLength();
+    return match.capturedStart();
+}
+
+int Matcher::indexIn(const QString &text, int from, int *matchedLength,
+                     bool *partial) const {
+    QRegularExpressionMatch match = regexp.match(
+                text, from, QRegularExpression::PartialPreferFirstMatch);
+    if (!match.hasMatch() && !match.hasPartialMatch()) {
+        return -1;
+    }
+
+    *partial = match.hasPartialMatch();
+    *matchedLength = match.capturedLength();
+    return match.capturedStart();
+}
+
+/**
+* Analizador de los primeros caracteres de una expresión regular con sintaxis
+* de PCRE. Cada función avanza pos sobre la construcción que reconoce y
+* retorna false si no la puede analizar.
+*/
+struct FirstAnalyzer
+{
+    /** Expresión regular que se analiza. */
+    QString pattern;
+
+    /** Posición actual en la expresión. */
+    int pos;
+
+    /** Retorna si se llegó al final de la expresión. */
+    bool atEnd() const {
+        return pos >= pattern.length();
+    }
+
+    /** Retorna el carácter de la posición actual. */
+    ushort peek() const {
+        return pattern.at(pos).unicode();
+    }
+
+    bool alternation(CharSet *first, bool *nullable);
+    bool sequence(CharSet *first, bool *nullable);
+    bool atom(CharSet *first, bool *nullable);
+    bool quantifier(bool *optional);
+    bool escape(CharSet *first, int *literal, bool *zeroWidth, bool inClass);
+    bool characterClass(CharSet *first);
+    uint hexNumber(int maxDigits, int *digits);
+    bool requiredLiteral(QString *literal, bool *prefix);
+};
+
+/**
+* Agrega a first los caracteres de la clase \d, \w o \s, o de su complemento
+* si kind es mayúscula. Con las propiedades Unicode activadas las clases
+* también contienen caracteres mayores que 255; sobre los caracteres Latin-1
+* el conjunto es exacto.
+*/
+static void addClassEscape(ushort kind, CharSet *first) {
+    CharSet result;
+    ushort lower = QChar::toLower(kind);
+    for (ushort c = 0; c < 256; ++c) {
+        QChar ch(c);
+        bool member = false;
+        if (lower == 'd') {
+            member = c >= '0' && c <= '9';
+        } else if (lower == 'w') {
+            member = ch.isLetterOrNumber() || c == '_';
+        } else {
+            member = ch.isSpace();
+        }
+        if (member) {
+            result.add(c);
+        }
+    }
+    result.add(0x100);
+    if (lower != kind) {
+        result.invert();
+    }
+    first->unite(result);
+}
+
+uint FirstAnalyzer::hexNumber(int maxDigits, int *digits) {
+    uint value = 0;
+    *digits = 0;
+    while (!atEnd() && *digits < maxDigits) {
+        ushort c = peek();
+        uint digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            break;
+        }
+        value = value * 16 + digit;
+        pos++;
+        (*digits)++;
+    }
+    return value;
+}
+
+bool FirstAnalyzer::escape(CharSet *first, int *literal, bool *zeroWidth,
+                           bool inClass) {
+    *literal = -1;
+    *zeroWidth = false;
+
+    /* pos se encuentra en la barra invertida.*/
+    pos++;
+    if (atEnd()) {
+        return false;
+    }
+    ushort c = peek();
+    pos++;
+
+    switch (c) {
+    case 'd': case 'D': case 'w': case 'W': case 's': case 'S':
+        addClassEscape(c, first);
+        return true;
+    case 't':
+        *literal = '\t';
+        break;
+    case 'n':
+        *literal = '\n';
+        break;
+    case 'r':
+        *literal = '\r';
+        break;
+    case 'f':
+        *literal = '\f';
+        break;
+    case 'a':
+        *literal = 0x07;
+        break;
+    case 'e':
+        *literal = 0x1B;
+        break;
+    case 'x': {
+        int digits = 0;
+        uint value = 0;
+        if (!atEnd() && peek() == '{') {
+            pos++;
+            value = hexNumber(8, &digits);
+            if (digits == 0 || atEnd() || peek() != '}') {
+                return false;
+            }
+            pos++;
+        } else {
+            value = hexNumber(2, &digits);
+        }
+
+        /* Los caracteres fuera del plano básico ocupan dos unidades UTF-16,
+        por lo que no se tratan como un carácter literal.*/
+        if (value > 0xFFFF) {
+            first->add(0xD800);
+            return true;
+        }
+        *literal = int(value);
+        break;
+    }
+    case '0': {
+        int value = 0;
+        for (int i = 0; i < 2 && !atEnd() && peek() >= '0' && peek() <= '7';
+             ++i) {
+            value = value * 8 + (peek() - '0');
+            pos++;
+        }
+        *literal = value;
+        break;
+    }
+    case 'b':
+
+        /* Dentro de una clase \b es el carácter de retroceso.*/
+        if (inClass) {
+            *literal = 0x08;
+            break;
+        }
+        *zeroWidth = true;
+        return true;
+    case 'B': case 'A': case 'z': case 'Z': case 'G':
+        *zeroWidth = true;
+        return !inClass;
+    case 'h': case 'H': case 'v': case 'V': case 'N': case 'R': case 'X':
+    case 'C': case 'p': case 'P':
+
+        /* Fuera de las clases se aproximan con el conjunto completo, lo que
+        nunca descarta una coincidencia posible.*/
+        if (inClass) {
+            return false;
+        }
+        if (c == 'p' || c == 'P') {
+            if (!atEnd() && peek() == '{') {
+                int close = pattern.indexOf(QLatin1Char('}'), pos);
+                if (close == -1) {
+                    return false;
+                }
+                pos = close + 1;
+            } else {
+                pos++;
+            }
+        }
+        first->unite(CharSet::full());
+        return true;
+    default:
+
+        /* Los caracteres que no son letras ni dígitos se escapan como
+        literales. Las referencias a grupos, \Q...\E, \K y el resto de las
+        secuencias no se analizan.*/
+        if (c < 128 && QChar(c).isLetterOrNumber()) {
+            return false;
+        }
+        *literal = c;
+        break;
+    }
+
+    first->add(ushort(*literal));
+    return true;
+}
+
+bool FirstAnalyzer::characterClass(CharSet *first) {
+
+    /* pos se encuentra en el corchete de apertura.*/
+    pos++;
+    bool negated = false;
+    if (!atEnd() && peek() == '^') {
+        negated = true;
+        pos++;
+    }
+
+    CharSet members;
+    bool firstItem = true;
+    while (!atEnd()) {
+        ushort c = peek();
+
+        /* Un ']' al inicio de la clase forma parte de ella.*/
+        if (c == ']' && !firstItem) {
+            pos++;
+            if (negated) {
+                members.invert();
+            }
+            first->unite(members);
+            return true;
+        }
+        firstItem = false;
+
+        /* Las clases POSIX no se analizan.*/
+        if (c == '[' && pos + 1 < pattern.length() &&
+                (pattern.at(pos + 1) == QLatin1Char(':') ||
+                 pattern.at(pos + 1) == QLatin1Char('.') ||
+                 pattern.at(pos + 1) == QLatin1Char('='))) {
+            return false;
+        }
+
+        /* Se obtiene el carácter del elemento, que puede ser el inicio de un
+        rango. Las clases \d, \w y \s se agregan directamente.*/
+        int low = c;
+        if (c == '\\') {
+            bool zeroWidth = false;
+            CharSet escaped;
+            if (!escape(&escaped, &low, &zeroWidth, true)) {
+                return false;
+            }
+            if (low == -1) {
+                members.unite(escaped);
+                continue;
+            }
+        } else {
+            pos++;
+        }
+
+        /* Un guión que no cierra la clase indica un rango.*/
+        if (pos + 1 < pattern.length() && peek() == '-' &&
+                pattern.at(pos + 1) != QLatin1Char(']')) {
+            pos++;
+            int high = peek();
+            if (high == '\\') {
+                bool zeroWidth = false;
+                CharSet escaped;
+                if (!escape(&escaped, &high, &zeroWidth, true) || high == -1) {
+                    return false;
+                }
+            } else {
+                pos++;
+            }
+            if (high < low) {
+                return false;
+            }
+            members.addRange(ushort(low), ushort(high));
+        } else {
+            members.add(ushort(low));
+        }
+    }
+    return false;
+}
+
+bool FirstAnalyzer::quantifier(bool *optional) {
+    *optional = false;
+    if (atEnd()) {
+        return true;
+    }
+
+    ushort c = peek();
+    if (c == '*' || c == '?') {
+        *optional = true;
+        pos++;
+    } else if (c == '+') {
+        pos++;
+    } else if (c == '{') {
+
+        /* Solo es un cuantificador si tiene la forma {n}, {n,} o {n,m}; en
+        otro caso la llave es un literal.*/
+        int end = pos + 1;
+        int minimum = 0;
+        bool digits = false;
+        while (end < pattern.length() && pattern.at(end).isDigit()) {
+            minimum = qMin(minimum * 10 + pattern.at(end).digitValue(), 65535);
+            digits = true;
+            end++;
+        }
+        if (end < pattern.length() && pattern.at(end) == QLatin1Char(',')) {
+            end++;
+            while (end < pattern.length() && pattern.at(end).isDigit()) {
+                end++;
+            }
+        }
+        if (!digits || end >= pattern.length() ||
+                pattern.at(end) != QLatin1Char('}')) {
+            return true;
+        }
+        *optional = minimum == 0;
+        pos = end + 1;
+    } else {
+        return true;
+    }
+
+    /* Se ignoran los modificadores perezoso y posesivo.*/
+    if (!atEnd() && (peek() == '?' || peek() == '+')) {
+        pos++;
+    }
+    return true;
+}
+
+bool FirstAnalyzer::atom(CharSet *first, bool *nullable) {
+    *nullable = false;
+    ushort c = peek();
+
+    switch (c) {
+    case '(': {
+        pos++;
+        bool assertion = false;
+        if (!atEnd() && peek() == '?') {
+            QStringRef rest = pattern.midRef(pos + 1, 2);
+            if (rest.startsWith(QLatin1Char(':')) ||
+                    rest.startsWith(QLatin1Char('>')) ||
+                    rest.startsWith(QLatin1Char('|'))) {
+                pos += 2;
+            } else if (rest.startsWith(QLatin1Char('=')) ||
+                       rest.startsWith(QLatin1Char('!'))) {
+                pos += 2;
+                assertion = true;
+            } else if (rest == QLatin1String("<=") ||
+                       rest == QLatin1String("<!")) {
+                pos += 3;
+                assertion = true;
+            } else if (rest.startsWith(QLatin1Char('<')) ||
+                       rest == QLatin1String("P<") ||
+                       rest.startsWith(QLatin1Char('\''))) {
+
+                /* Grupo con nombre, se salta el nombre.*/
+                QLatin1Char close = rest.startsWith(QLatin1Char('\'')) ?
+                            QLatin1Char('\'') : QLatin1Char('>');
+                int end = pattern.indexOf(close, pos + 3);
+                if (end == -1) {
+                    return false;
+                }
+                pos = end + 1;
+            } else {
+
+                /* Opciones en línea, comentarios, recursión y condiciones.*/
+                return false;
+            }
+        }
+
+        CharSet inner;
+        bool innerNullable = false;
+        if (!alternation(&inner, &innerNullable) || atEnd() || peek() != ')') {
+            return false;
+        }
+        pos++;
+
+        /* Las aserciones no consumen texto, por lo que no restringen el
+        primer carácter de la coincidencia.*/
+        if (assertion) {
+            *nullable = true;
+        } else {
+            first->unite(inner);
+            *nullable = innerNullable;
+        }
+        return true;
+    }
+    case '[':
+        return characterClass(first);
+    case '.':
+        pos++;
+        first->unite(CharSet::full());
+        return true;
+    case '^':
+    case '$':
+        pos++;
+        *nullable = true;
+        return true;
+    case '\\': {
+        int literal = -1;
+        if (!escape(first, &literal, nullable, false)) {
+            return false;
+        }
+        return true;
+    }
+    case '*':
+    case '+':
+    case '?':
+        return false;
+    default:
+        pos++;
+        first->add(c);
+        return true;
+    }
+}
+
+bool FirstAnalyzer::sequence(CharSet *first, bool *nullable) {
+
+    /* Se agregan los primeros caracteres de cada elemento hasta encontrar uno
+    que no pueda ser vacío; los siguientes solo se recorren.*/
+    bool complete = false;
+    while (!atEnd() && peek() != '|' && peek() != ')') {
+        CharSet element;
+        bool elementNullable = false;
+        bool optional = false;
+        if (!atom(&element, &elementNullable) || !quantifier(&optional)) {
+            return false;
+        }
+        if (!complete) {
+            first->unite(element);
+            complete = !elementNullable && !optional;
+        }
+    }
+    *nullable = !complete;
+    return true;
+}
+
+bool FirstAnalyzer::alternation(CharSet *first, bool *nullable) {
+    *nullable = false;
+    while (true) {
+        bool branchNullable = false;
+        if (!sequence(first, &branchNullable)) {
+            return false;
+        }
+        *nullable = *nullable || branchNullable;
+        if (atEnd() || peek() != '|') {
+            return true;
+        }
+        pos++;
+    }
+}
+
+bool Matcher::firstChars(CharSet *first) const {
+    FirstAnalyzer analyzer;
+    analyzer.pattern = translate(patternStr);
+    analyzer.pos = 0;
+
+    CharSet result;
+    bool nullable = false;
+    if (!analyzer.alternation(&result, &nullable) || !analyzer.atEnd()) {
+        return false;
+    }
+    first->unite(result);
+    return true;
+}
+
+bool FirstAnalyzer::requiredLiteral(QString *literal, bool *prefix) {
+    QString run;
+    bool runIsPrefix = true;
+    *prefix = false;
+
+    /* Se recorren los elementos del primer nivel formando secuencias de
+    caracteres literales consecutivos. Las aserciones no consumen texto, por
+    lo que no interrumpen la secuencia.*/
+    while (!atEnd()) {
+        ushort c = peek();
+        int character = -1;
+        bool zeroWidth = false;
+
+        if (c == '|' || c == ')') {
+
+            /* Con alternativas en el primer nivel no hay un texto común.*/
+            return false;
+        } else if (c == '\\') {
+            CharSet escaped;
+            if (!escape(&escaped, &character, &zeroWidth, false)) {
+                return false;
+            }
+        } else if (c != '(' && c != '[' && c != '.' && c != '^' && c != '$' &&
+                   c != '*' && c != '+' && c != '?') {
+            character = c;
+            pos++;
+        } else {
+            CharSet element;
+            if (!atom(&element, &zeroWidth)) {
+                return false;
+            }
+            zeroWidth = zeroWidth && element.isEmpty();
+        }
+
+        int quantifierStart = pos;
+        bool optional = false;
+        if (!quantifier(&optional)) {
+            return false;
+        }
+        bool repeated = pos != quantifierStart;
+        if (zeroWidth) {
+            continue;
+        }
+
+        /* Un carácter obligatorio se agrega a la secuencia; si se repite, la
+        secuencia termina con él. Cualquier otro elemento la termina.*/
+        if (character != -1 && !optional) {
+            run.append(QChar(ushort(character)));
+        }
+        if (character == -1 || repeated) {
+            if (runIsPrefix && !run.isEmpty()) {
+                *literal = run;
+                *prefix = true;
+            } else if (run.length() > literal->length() && !*prefix) {
+                *literal = run;
+            }
+            run.clear();
+            runIsPrefix = false;
+        }
+    }
+
+    if (runIsPrefix && !run.isEmpty()) {
+        *literal = run;
+        *prefix = true;
+    } else if (run.length() > literal->length() && !*prefix) {
+        *literal = run;
+    }
+    return true;
+}
+
+void Matcher::extractLiteral() {
+
+    /* Se prefiere el texto con que comienzan las coincidencias, ya que
+    permite saltar directamente a ellas; en otro caso se utiliza el más largo
+    de los textos obligatorios para descartar las búsquedas sin resultado.*/
+    FirstAnalyzer analyzer;
+    analyzer.pattern = translate(patternStr);
+    analyzer.pos = 0;
+
+    QString found;
+    bool prefix = false;
+    if (analyzer.requiredLiteral(&found, &prefix)) {
+        this->literal = found;
+        this->literalPrefix = prefix;
+    }
+}
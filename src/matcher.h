@@ -0,0 +1,164 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef MATCHER_H
+#define MATCHER_H
+
+#include <QString>
+#include <QStringRef>
+#include <QRegularExpression>
+
+#include <charset.h>
+
+/**
+* Matcher encapsula una expresión regular de la gramática compilada una sola
+* vez. Las búsquedas se realizan directamente sobre el texto original, a partir
+* de una posición o dentro de una referencia de texto, sin copiar la entrada.
+*
+* Las expresiones se escriben con la sintaxis de QRegExp, por lo que al
+* compilarlas se conserva su semántica: el punto reconoce también los saltos de
+* línea, "$" solo coincide con el final del texto y, en modo mínimo, todos los
+* cuantificadores son no codiciosos.
+*/
+class Matcher
+{
+    private:
+
+        /** Expresión regular tal como se definió en la gramática. */
+        QString patternStr;
+
+        /** Expresión regular compilada. */
+        QRegularExpression regexp;
+
+        /**
+        * Texto que contiene toda coincidencia de la expresión, o vacío si no
+        * se pudo determinar.
+        */
+        QString literal;
+
+        /** Indica si toda coincidencia comienza con literal. */
+        bool literalPrefix;
+
+        /**
+        * Obtiene de la expresión regular el texto literal más largo que debe
+        * aparecer en toda coincidencia.
+        */
+        void extractLiteral();
+
+        /**
+        * Busca literal en subject a partir de la posición from. Se localiza
+        * su primer carácter con la búsqueda vectorizada de QString y luego se
+        * compara el resto.
+        * @return Devuelve la posición encontrada o -1 si no aparece.
+        */
+        template <typename Subject>
+        int findLiteral(const Subject &subject, int from) const;
+
+        /**
+        * Busca la primera coincidencia en subject a partir de la posición
+        * from, saltando con literal a las posiciones candidatas.
+        */
+        template <typename Subject>
+        QRegularExpressionMatch search(const Subject &subject, int from) const;
+
+        /**
+        * Traduce una expresión regular con sintaxis de QRegExp a la sintaxis
+        * de PCRE.
+        * @param pattern expresión regular original.
+        * @return Devuelve la expresión regular equivalente.
+        */
+        static QString translate(const QString &pattern);
+
+    public:
+
+        /** Constructor por defecto, crea un reconocedor vacío. */
+        Matcher();
+
+        /**
+        * Constructor.
+        * @param pattern expresión regular con sintaxis de QRegExp.
+        * @param minimal indica si los cuantificadores son no codiciosos.
+        */
+        Matcher(const QString &pattern, bool minimal = true);
+
+        /** Retorna la expresión regular original. */
+        QString pattern() const;
+
+        /** Retorna si no se ha definido una expresión regular. */
+        bool isEmpty() const;
+
+        /** Retorna si la expresión regular es correcta. */
+        bool isValid() const;
+
+        /** Retorna el mensaje de error de la expresión regular. */
+        QString errorString() const;
+
+        /**
+        * Retorna el texto literal que debe aparecer en toda coincidencia, o
+        * vacío si no existe, con el que se descartan las posiciones donde no
+        * puede haber una coincidencia antes de evaluar la expresión regular.
+        */
+        QString requiredLiteral() const;
+
+        /**
+        * Busca la primera coincidencia dentro de la referencia text. El texto
+        * referenciado se trata como si fuera la entrada completa, igual que al
+        * analizar una copia del mismo.
+        * @param text referencia al texto a analizar.
+        * @param matchedLength longitud del texto reconocido.
+        * @return Devuelve la posición de la coincidencia relativa al inicio de
+        * la referencia o -1 si no existe.
+        */
+        int indexIn(const QStringRef &text, int *matchedLength) const;
+
+        /**
+        * Busca la primera coincidencia dentro de la referencia text a partir
+        * de la posición from, relativa al inicio de la referencia. El texto
+        * anterior a from forma parte de la entrada, por lo que las anclas y
+        * aserciones lo tienen en cuenta.
+        * @param text referencia al texto a analizar.
+        * @param from posición inicial de la búsqueda.
+        * @param matchedLength longitud del texto reconocido.
+        * @return Devuelve la posición de la coincidencia relativa al inicio de
+        * la referencia o -1 si no existe.
+        */
+        int indexIn(const QStringRef &text, int from, int *matchedLength) const;
+
+        /**
+        * Busca la primera coincidencia en text a partir de la posición from.
+        * @param text texto a analizar.
+        * @param from posición inicial de la búsqueda.
+        * @param matchedLength longitud del texto reconocido.
+        * @return Devuelve la posición de la coincidencia o -1 si no existe.
+        */
+        int indexIn(const QString &text, int from, int *matchedLength) const;
+
+        /**
+        * Busca la primera coincidencia en text a partir de la posición from,
+        * considerando que el texto puede continuar. Si antes de encontrar una
+        * coincidencia completa se llega al final del texto con una
+        * coincidencia parcial, se reporta esta última.
+        * @param text texto a analizar.
+        * @param from posición inicial de la búsqueda.
+        * @param matchedLength longitud del texto reconocido.
+        * @param partial indica si la coincidencia es parcial.
+        * @return Devuelve la posición de la coincidencia o -1 si no existe.
+        */
+        int indexIn(const QString &text, int from, int *matchedLength,
+                    bool *partial) const;
+
+        /**
+        * Calcula los caracteres con que puede comenzar una coincidencia no
+        * vacía de la expresión regular. Se reconocen literales, clases de
+        * caracteres, grupos, alternativas y cuantificadores; las aserciones
+        * se ignoran, ya que no consumen texto.
+        * @param first conjunto donde se agregan los caracteres.
+        * @return Devuelve false si la expresión utiliza construcciones que no
+        * se pueden analizar, como referencias a grupos u opciones en línea.
+        */
+        bool firstChars(CharSet *first) const;
+};
+
+#endif // MATCHER_H
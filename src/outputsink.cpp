@@ -0,0 +1,24 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <outputsink.h>
+
+OutputSink::~OutputSink() {
+}
+
+void OutputSink::begin() {
+}
+
+void OutputSink::unknown(const QStringRef &text, qint64 offset) {
+    Q_UNUSED(text);
+    Q_UNUSED(offset);
+}
+
+void OutputSink::end() {
+}
+
+QString OutputSink::milliseconds(qint64 nsecs) {
+    return QString::number(double(nsecs) / 1000000.0, 'f', 3);
+}
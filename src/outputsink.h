@@ -0,0 +1,97 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef OUTPUTSINK_H
+#define OUTPUTSINK_H
+
+#include <QString>
+#include <QStringRef>
+
+class AstNode;
+class SymbolTable;
+
+/**
+* Occurrence describe una ocurrencia de un formato reconocida en la entrada.
+*/
+struct Occurrence
+{
+    /** Nombre del formato reconocido. */
+    QString format;
+
+    /**
+    * Texto de la ocurrencia, referenciado dentro del texto analizado sin
+    * copiarlo. Las posiciones de los nodos del árbol son relativas al mismo
+    * texto que esta referencia.
+    */
+    QStringRef input;
+
+    /** Posición de la ocurrencia en la entrada completa. */
+    qint64 offset;
+
+    /**
+    * Posición en bytes de la ocurrencia en la entrada UTF-8, o -1 si la
+    * entrada no se leyó como UTF-8.
+    */
+    qint64 byteOffset;
+
+    /** Árbol sintáctico de la ocurrencia. */
+    AstNode *tree;
+
+    /** Tabla de símbolos de la gramática que generó el árbol. */
+    const SymbolTable *symbols;
+
+    /** Tiempo de análisis de la ocurrencia en nanosegundos. */
+    qint64 nsecs;
+
+    /**
+    * Retorna el valor que se suma a la posición de un nodo para obtener su
+    * posición en la entrada completa.
+    */
+    qint64 base() const {
+        return offset - input.position();
+    }
+};
+
+/**
+* OutputSink recibe los resultados del análisis a medida que se producen, de
+* forma que puedan escribirse o procesarse sin esperar a que termine el
+* análisis de toda la entrada.
+*/
+class OutputSink
+{
+    public:
+
+        /** Destructor. */
+        virtual ~OutputSink();
+
+        /** Se invoca antes de entregar el primer resultado. */
+        virtual void begin();
+
+        /**
+        * Recibe una ocurrencia reconocida. El árbol y el texto solo son
+        * válidos durante la llamada.
+        * @param ocur ocurrencia reconocida.
+        */
+        virtual void occurrence(const Occurrence &ocur) = 0;
+
+        /**
+        * Recibe una sección de la entrada que no corresponde a ningún formato.
+        * @param text texto no reconocido.
+        * @param offset posición del texto en la entrada completa.
+        */
+        virtual void unknown(const QStringRef &text, qint64 offset);
+
+        /** Se invoca después de entregar el último resultado. */
+        virtual void end();
+
+        /**
+        * Convierte un tiempo en nanosegundos al texto en milisegundos con
+        * tres decimales que se escribe en el atributo de tiempo.
+        * @param nsecs tiempo en nanosegundos.
+        */
+        static QString milliseconds(qint64 nsecs);
+};
+
+#endif // OUTPUTSINK_H
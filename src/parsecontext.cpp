@@ -0,0 +1,151 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <parsecontext.h>
+
+MemoStats::MemoStats() {
+    lookups = 0;
+    hits = 0;
+    stores = 0;
+    rejected = 0;
+    peakBytes = 0;
+}
+
+double MemoStats::hitRate() const {
+    return lookups == 0 ? 0.0 : double(hits) / double(lookups);
+}
+
+void MemoStats::add(const MemoStats &other) {
+    lookups += other.lookups;
+    hits += other.hits;
+    stores += other.stores;
+    rejected += other.rejected;
+    peakBytes = qMax(peakBytes, other.peakBytes);
+}
+
+ParseContext::ParseContext(bool memoize, qint64 limit) {
+    this->arena = NULL;
+    this->memoEnabled = memoize;
+    this->memoLimit = limit;
+    this->memoBytes = 0;
+    this->projection = NULL;
+    this->lookahead = NULL;
+}
+
+void ParseContext::clear() {
+    memo.clear();
+    memoArena.clear();
+    memoBytes = 0;
+}
+
+void ParseContext::reset(bool memoize, qint64 limit) {
+    clear();
+    this->memoEnabled = memoize;
+    this->memoLimit = limit;
+    this->stats = MemoStats();
+    this->arena = NULL;
+    this->projection = NULL;
+    this->lookahead = NULL;
+}
+
+Arena &ParseContext::nodeArena() {
+    return *this->arena;
+}
+
+void ParseContext::setNodeArena(Arena *arena) {
+    this->arena = arena;
+}
+
+Arena &ParseContext::memoNodeArena() {
+    return this->memoArena;
+}
+
+bool ParseContext::isMemoEnabled() const {
+    return this->memoEnabled;
+}
+
+void ParseContext::setProjection(const Projection *projection) {
+    this->projection = projection;
+}
+
+bool ParseContext::prunes(int rule) const {
+    return projection && !projection->keeps(rule);
+}
+
+void ParseContext::setLookahead(const QVector<CharSet> *sets) {
+    this->lookahead = sets;
+    if (!sets) {
+        return;
+    }
+
+    /* Las búsquedas guardadas no son válidas en un nuevo análisis, ya que el
+    mismo texto puede haber cambiado.*/
+    lookaheadHits.resize(sets->size());
+    for (int i = 0; i < lookaheadHits.size(); ++i) {
+        lookaheadHits[i].string = NULL;
+    }
+}
+
+int ParseContext::firstCandidate(int rule, const QStringRef &text) {
+    if (!lookahead) {
+        return text.position();
+    }
+
+    /* Si la sección comienza entre la búsqueda anterior y el carácter
+    encontrado, y termina en el mismo punto, el resultado es el mismo.*/
+    int start = text.position();
+    int end = start + text.length();
+    LookaheadHit &hit = lookaheadHits[rule];
+    if (hit.string == text.string() && hit.end == end && start >= hit.start &&
+            (hit.index == -1 || start <= hit.index)) {
+        return hit.index;
+    }
+
+    int index = lookahead->at(rule).indexIn(text);
+    hit.string = text.string();
+    hit.start = start;
+    hit.end = end;
+    hit.index = index == -1 ? -1 : start + index;
+    return hit.index;
+}
+
+bool ParseContext::lookup(const MemoKey &key, MemoEntry *entry) {
+    stats.lookups++;
+    QHash<MemoKey, MemoEntry>::const_iterator it = memo.constFind(key);
+    if (it == memo.constEnd()) {
+        return false;
+    }
+    stats.hits++;
+    *entry = it.value();
+    return true;
+}
+
+bool ParseContext::reserve(qint64 cost) {
+    if (memoBytes + cost > memoLimit) {
+        stats.rejected++;
+        return false;
+    }
+    return true;
+}
+
+void ParseContext::store(const MemoKey &key, const MemoEntry &entry, qint64 cost) {
+    memo.insert(key, entry);
+    memoBytes += cost;
+    stats.stores++;
+    stats.peakBytes = qMax(stats.peakBytes, memoBytes);
+}
+
+MemoStats ParseContext::memoStats() const {
+    return this->stats;
+}
+
+void ParseContext::startProfile(int ruleCount) {
+    RuleCounters empty = { 0, 0, 0, 0 };
+    ruleCounters.fill(empty, ruleCount);
+}
+
+const QVector<RuleCounters> &ParseContext::ruleProfile() const {
+    return this->ruleCounters;
+}
@@ -0,0 +1,264 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef PARSECONTEXT_H
+#define PARSECONTEXT_H
+
+#include <QHash>
+#include <QVector>
+
+#include <arena.h>
+#include <projection.h>
+#include <charset.h>
+#include <ruleprofiler.h>
+
+#define DEFAULT_MEMO_LIMIT (4 * 1024 * 1024)
+
+class AstNode;
+
+/**
+* MemoKey identifica la evaluación de una regla sobre una sección de la
+* entrada: el índice de la regla y las posiciones de inicio y fin del texto
+* referenciado.
+*/
+struct MemoKey
+{
+    int rule;
+    int position;
+    int end;
+};
+
+inline bool operator==(const MemoKey &a, const MemoKey &b) {
+    return a.rule == b.rule && a.position == b.position && a.end == b.end;
+}
+
+inline uint qHash(const MemoKey &key, uint seed = 0) {
+    return qHash((quint64(uint(key.rule)) << 32) | uint(key.position), seed) ^
+            uint(key.end);
+}
+
+/** MemoEntry guarda el resultado memorizado de evaluar una regla. */
+struct MemoEntry
+{
+    /** Indica si la regla fue reconocida o se trata de una ausencia opcional. */
+    bool matched;
+
+    /**
+    * Copia del árbol reconocido, reservada en la arena de la tabla, o NULL si
+    * el resultado fue un nodo vacío.
+    */
+    AstNode *tree;
+
+    /** Posición de la referencia de texto tras evaluar la regla. */
+    int endPosition;
+};
+
+/**
+* LookaheadHit guarda la última búsqueda de los primeros caracteres de una
+* regla, que sigue siendo válida mientras el texto avanza sin sobrepasar el
+* carácter encontrado.
+*/
+struct LookaheadHit
+{
+    /** Texto donde se buscó, o NULL si no hay una búsqueda guardada. */
+    const QString *string;
+
+    /** Posición inicial de la búsqueda. */
+    int start;
+
+    /** Posición final de la sección analizada. */
+    int end;
+
+    /** Posición del primer carácter encontrado o -1 si no existe. */
+    int index;
+};
+
+/** MemoStats acumula los contadores de uso de la tabla de memorización. */
+struct MemoStats
+{
+    /** Cantidad de consultas realizadas a la tabla. */
+    qint64 lookups;
+
+    /** Cantidad de consultas que encontraron un resultado. */
+    qint64 hits;
+
+    /** Cantidad de resultados guardados. */
+    qint64 stores;
+
+    /** Cantidad de resultados descartados por alcanzar el límite de memoria. */
+    qint64 rejected;
+
+    /** Mayor cantidad de memoria utilizada en un mismo análisis. */
+    qint64 peakBytes;
+
+    /** Constructor, inicializa todos los contadores en cero. */
+    MemoStats();
+
+    /** Retorna la proporción de consultas que encontraron un resultado. */
+    double hitRate() const;
+
+    /** Suma los contadores de other a los de este objeto. */
+    void add(const MemoStats &other);
+};
+
+/**
+* ParseContext contiene el estado temporal de un análisis, de forma que el
+* Parser no se modifique mientras procesa una entrada. Incluye la arena donde se
+* crean los nodos del resultado y la tabla de memorización (packrat) de las
+* reglas evaluadas en cada posición.
+*/
+class ParseContext
+{
+    private:
+
+        /** Arena donde se crean los nodos del resultado. */
+        Arena *arena;
+
+        /** Arena donde se guardan las copias de los árboles memorizados. */
+        Arena memoArena;
+
+        /** Indica si se memorizan los resultados. */
+        bool memoEnabled;
+
+        /** Límite aproximado de memoria en bytes para la tabla. */
+        qint64 memoLimit;
+
+        /** Memoria aproximada utilizada por la tabla. */
+        qint64 memoBytes;
+
+        /** Tabla de resultados memorizados. */
+        QHash<MemoKey, MemoEntry> memo;
+
+        /** Contadores de uso de la tabla. */
+        MemoStats stats;
+
+        /** Proyección con que se reducen los subárboles, o NULL. */
+        const Projection *projection;
+
+        /** Primeros caracteres de cada regla, o NULL. */
+        const QVector<CharSet> *lookahead;
+
+        /** Última búsqueda de los primeros caracteres de cada regla. */
+        QVector<LookaheadHit> lookaheadHits;
+
+        /** Contadores de evaluación de cada regla en este análisis. */
+        QVector<RuleCounters> ruleCounters;
+
+    public:
+
+        /**
+        * Constructor.
+        * @param memoize indica si se memorizan los resultados.
+        * @param limit límite aproximado de memoria en bytes para la tabla.
+        */
+        ParseContext(bool memoize = false, qint64 limit = DEFAULT_MEMO_LIMIT);
+
+        /** Elimina todos los resultados memorizados. */
+        void clear();
+
+        /**
+        * Prepara el contexto para un nuevo análisis conservando la memoria
+        * reservada en análisis anteriores.
+        * @param memoize indica si se memorizan los resultados.
+        * @param limit límite aproximado de memoria en bytes para la tabla.
+        */
+        void reset(bool memoize, qint64 limit);
+
+        /** Retorna la arena donde se crean los nodos del resultado. */
+        Arena &nodeArena();
+
+        /** Establece la arena donde se crean los nodos del resultado. */
+        void setNodeArena(Arena *arena);
+
+        /** Retorna la arena donde se guardan los árboles memorizados. */
+        Arena &memoNodeArena();
+
+        /** Retorna si se memorizan los resultados. */
+        bool isMemoEnabled() const;
+
+        /** Establece la proyección con que se reducen los subárboles. */
+        void setProjection(const Projection *projection);
+
+        /**
+        * Retorna si los descendientes del nodo de la regla rule se pueden
+        * descartar según la proyección.
+        */
+        bool prunes(int rule) const;
+
+        /**
+        * Establece los primeros caracteres de cada regla, con que se
+        * descartan las alternativas que no pueden reconocerse, y descarta las
+        * búsquedas guardadas del análisis anterior.
+        */
+        void setLookahead(const QVector<CharSet> *sets);
+
+        /**
+        * Retorna la primera posición de text donde puede comenzar un texto no
+        * vacío reconocido por la regla rule. La búsqueda se guarda por regla,
+        * de forma que al avanzar por el texto no se vuelve a recorrer la
+        * sección anterior al carácter encontrado.
+        * @return Devuelve la posición respecto al texto completo, o -1 si la
+        * regla no puede reconocer ningún texto dentro de text. Sin primeros
+        * caracteres establecidos devuelve el inicio de text.
+        */
+        int firstCandidate(int rule, const QStringRef &text);
+
+        /**
+        * Busca un resultado memorizado.
+        * @param key regla y sección de texto evaluada.
+        * @param entry resultado encontrado.
+        * @return Devuelve true si existe un resultado para key.
+        */
+        bool lookup(const MemoKey &key, MemoEntry *entry);
+
+        /**
+        * Comprueba si se puede guardar un resultado sin sobrepasar el límite de
+        * memoria, en caso contrario lo contabiliza como descartado.
+        * @param cost memoria aproximada que ocupará el resultado.
+        */
+        bool reserve(qint64 cost);
+
+        /**
+        * Guarda un resultado en la tabla. El árbol debe estar reservado en la
+        * arena de memorización.
+        * @param key regla y sección de texto evaluada.
+        * @param entry resultado a guardar.
+        * @param cost memoria aproximada reservada para el resultado.
+        */
+        void store(const MemoKey &key, const MemoEntry &entry, qint64 cost);
+
+        /** Retorna los contadores de uso de la tabla. */
+        MemoStats memoStats() const;
+
+        /**
+        * Reinicia los contadores de evaluación para una gramática de
+        * ruleCount reglas, conservando la memoria reservada.
+        */
+        void startProfile(int ruleCount);
+
+        /**
+        * Registra una evaluación de la regla rule en los contadores del
+        * análisis, que no se comparten con otros hilos.
+        * @param rule índice de la regla.
+        * @param matched indica si la regla reconoció texto.
+        * @param consumed cantidad de caracteres consumidos.
+        * @param nsecs tiempo de la evaluación en nanosegundos.
+        */
+        inline void record(int rule, bool matched, qint64 consumed,
+                           qint64 nsecs) {
+            RuleCounters &c = ruleCounters[rule];
+            c.attempts++;
+            c.nsecs += nsecs;
+            if (matched) {
+                c.successes++;
+                c.consumed += consumed;
+            }
+        }
+
+        /** Retorna los contadores de evaluación del análisis. */
+        const QVector<RuleCounters> &ruleProfile() const;
+};
+
+#endif // PARSECONTEXT_H
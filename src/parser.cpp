@@ -5,15 +5,36 @@
 
 #include <QDebug>
 #include <QFile>
+#include <QTextStream>
+#include <QElapsedTimer>
 
 #include <parser.h>
 #include <astnode.h>
 #include <dictionarymanager.h>
+#include <dictionarymatcher.h>
+#include <parsecontext.h>
+#include <parseresult.h>
+#include <batchresult.h>
+#include <parsevisitor.h>
+#include <arena.h>
+
+/**
+* Nodo nulo compartido que se retorna cuando no se encuentra un elemento
+* opcional. Nunca se modifica ni se agrega a un árbol.
+*/
+static AstNode emptyNode;
 
 Parser::Parser(QDomElement rules, DictionaryManager *dictMgr) {
-    this->rules = rules;
-    this->format = rules.attribute(ATTR_NAME, DEFAULT_FORMAT);
     this->dictManager = dictMgr;
+    this->memoEnabled = false;
+    this->memoLimit = DEFAULT_MEMO_LIMIT;
+    this->lookaheadEnabled = true;
+    this->lookahead.storeRelease(NULL);
+    setRules(rules);
+}
+
+Parser::~Parser() {
+    releaseLookahead();
 }
 
 QString Parser::getFormat() {
@@ -21,33 +42,73 @@ QString Parser::getFormat() {
 }
 
 void Parser::setRules(QDomElement rules) {
-    this->rules = rules;
-    this->format = rules.attribute(ATTR_NAME, DEFAULT_FORMAT);
+    this->grammar.compile(rules);
+    this->format = grammar.getFormat();
+    this->profiler.reset(grammar.ruleCount());
+    releaseLookahead();
 }
 
-QRegExp Parser::matchExp() {
+void Parser::releaseLookahead() {
+    QMutexLocker locker(&lookaheadMutex);
+    delete lookahead.loadAcquire();
+    lookahead.storeRelease(NULL);
+    qDeleteAll(retiredLookahead);
+    retiredLookahead.clear();
+}
 
-    /* Se busca la primera producción de la gramática.*/
-    QDomElement start = rules.firstChildElement(format);
-    if (start.isNull()) {
-        qCritical() << "Parser: No se pudo encontrar el elemento inicial de "
-                       "la gramatica del formato " << format;
-        return QRegExp();
+const LookaheadTable *Parser::lookaheadTable() {
+    const LookaheadTable *table = lookahead.loadAcquire();
+    if (table && table->generation == dictManager->generation()) {
+        return table;
+    }
+
+    /* Se comprueba de nuevo con el bloqueo, ya que otro hilo pudo calcular
+    la tabla.*/
+    QMutexLocker locker(&lookaheadMutex);
+    table = lookahead.loadAcquire();
+    if (table && table->generation == dictManager->generation()) {
+        return table;
+    }
+
+    /* Se cargan los diccionarios antes de leer la generación, de forma que
+    su carga no invalide la tabla calculada.*/
+    preloadDictionaries();
+    LookaheadTable *next = new LookaheadTable;
+    next->generation = dictManager->generation();
+    next->sets.resize(grammar.ruleCount());
+    for (int i = 0; i < grammar.ruleCount(); ++i) {
+        const Rule &rule = grammar.rule(i);
+        CharSet &set = next->sets[i];
+        set = rule.first;
+        for (int j = 0; j < rule.firstDictionaries.size(); ++j) {
+            const DictionaryMatcher *dictionary =
+                    dictManager->getDictionary(rule.firstDictionaries.at(j));
+            if (dictionary) {
+                dictionary->firstChars(&set);
+            }
+        }
     }
 
-    /* Se obtiene el texto de la expresión regular de la primera producción.*/
-    QString regexpStr = start.attribute(ATTR_REGEXP);
-    if (regexpStr.isEmpty()) {
-        qCritical() << "Parser: No se ha definido el atributo " ATTR_REGEXP
-                       " para el elemento" << format;
+    /* La tabla anterior se retira, ya que algún análisis puede seguir
+    usándola.*/
+    if (table) {
+        retiredLookahead.append(table);
+    }
+    lookahead.storeRelease(next);
+    return next;
+}
+
+QRegExp Parser::matchExp() {
+
+    /* Se busca la primera producción de la gramática.*/
+    int start = grammar.startRule();
+    if (start == -1) {
         return QRegExp();
     }
 
     /* Se genera la expresión regular de la primera producción.*/
-    QRegExp regexp(regexpStr);
-    if (!regexp.isValid()) {
-        qCritical() << "Parser: La expresion regular para el elemento" <<
-                       format << "no es correcta";
+    QRegExp regexp(grammar.rule(start).matcher.pattern());
+    if (regexp.isEmpty() || !regexp.isValid()) {
         return QRegExp();
     }
 
@@ -55,154 +116,405 @@ QRegExp Parser::matchExp() {
     return regexp;
 }
 
-AstNode *Parser::parse(QString *input) {
+Matcher Parser::formatMatcher() {
+
+    /* Se busca la primera producción de la gramática.*/
+    int start = grammar.startRule();
+    if (start == -1) {
+        return Matcher();
+    }
+
+    return grammar.rule(start).matcher;
+}
+
+QString Parser::recordDelimiter() {
+    return grammar.recordDelimiter();
+}
+
+AstNode *Parser::parse(QString *input, ParseResult &result) {
+    return parse(QStringRef(input), result);
+}
+
+AstNode *Parser::parse(const QStringRef &input, ParseResult &result) {
+
+    result.clear();
+    result.setSymbolTable(&grammar.symbolTable());
 
     /* Se busca la primera producción de la gramática.*/
-    QDomElement start = rules.firstChildElement(format);
-    if (start.isNull()) {
-        qCritical() << "No se pudo encontrar el elemento inicial de la "
-                       "gramatica del formato" << format;
+    int start = grammar.startRule();
+    if (start == -1) {
         return NULL;
     }
 
     /* Se procesa la entrada de texto en busca de una aparición del formato
-    desado.*/
-    QStringRef matchRef(input);
-    AstNode *block = process(matchRef, start);
+    desado, creando los nodos en la arena del resultado.*/
+    ParseContext &context = result.context();
+    context.reset(memoEnabled, memoLimit);
+    prepareContext(context, &result.nodeArena());
+    AstNode *block = parseSlice(input, start, context);
+    collectStats(context);
 
     /* Si no coincide el texto analizado con la expresión regular.*/
     if (!block) {
+        result.clear();
         return NULL;
     }
 
-    if (block->isNull()) {
-        delete block;
-        return NULL;
+    result.setRoot(block);
+    return block;
+}
+
+void Parser::prepareContext(ParseContext &context, Arena *arena) {
+    context.setNodeArena(arena);
+    if (projection.isActive()) {
+        context.setProjection(&projection);
     }
+    context.setLookahead(lookaheadEnabled ? &lookaheadTable()->sets : NULL);
+#ifdef GENERIC_PARSER_PROFILING
+    context.startProfile(grammar.ruleCount());
+#endif
+}
 
+void Parser::collectStats(const ParseContext &context) {
+    statsMutex.lock();
+    memoTotals.add(context.memoStats());
+    statsMutex.unlock();
+
+    /* Los contadores de evaluación se suman al perfil una vez por análisis,
+    sin que los hilos compitan por ellos en cada regla evaluada.*/
+#ifdef GENERIC_PARSER_PROFILING
+    profiler.add(context.ruleProfile());
+#endif
+}
+
+AstNode *Parser::parseSlice(const QStringRef &text, int start,
+                            ParseContext &context) {
+    Arena::Mark mark = context.nodeArena().mark();
+    QStringRef matchRef = text;
+    AstNode *block = process(matchRef, start, context);
+    if (!block || block->isNull()) {
+        context.nodeArena().rewind(mark);
+        return NULL;
+    }
     return block;
 }
 
-AstNode *Parser::process(QStringRef &textRef, QDomElement subRules) {
+int Parser::parse(const QStringList &records, BatchResult &batch) {
+    batch.clear(records.size());
+    batch.setSymbolTable(&grammar.symbolTable());
+
+    int start = grammar.startRule();
+    ParseContext context(memoEnabled, memoLimit);
+    prepareContext(context, &batch.nodeArena());
+
+    /* La tabla de memorización se vacía entre registros, ya que las
+    posiciones de registros distintos pueden coincidir.*/
+    for (int i = 0; i < records.size(); ++i) {
+        AstNode *block = NULL;
+        if (start != -1) {
+            block = parseSlice(QStringRef(&records.at(i)), start, context);
+            context.clear();
+        }
+        batch.append(block);
+    }
+
+    collectStats(context);
+    return batch.matchedCount();
+}
+
+int Parser::parse(const QString &buffer, const QVector<int> &offsets,
+                  BatchResult &batch) {
+    batch.clear(offsets.size());
+    batch.setSymbolTable(&grammar.symbolTable());
+
+    int start = grammar.startRule();
+    ParseContext context(memoEnabled, memoLimit);
+    prepareContext(context, &batch.nodeArena());
+
+    /* Cada registro se analiza como una referencia al texto del buffer; la
+    tabla de memorización se vacía entre registros para que el límite de
+    memoria se aplique a cada uno.*/
+    for (int i = 0; i < offsets.size(); ++i) {
+        int end = i + 1 < offsets.size() ? offsets.at(i + 1) : buffer.length();
+        AstNode *block = NULL;
+        if (start != -1) {
+            QStringRef record(&buffer, offsets.at(i), end - offsets.at(i));
+            block = parseSlice(record, start, context);
+            context.clear();
+        }
+        batch.append(block);
+    }
+
+    collectStats(context);
+    return batch.matchedCount();
+}
+
+bool Parser::parse(QString *input, ParseResult &scratch,
+                   ParseVisitor *visitor, qint64 offset) {
+    AstNode *tree = parse(input, scratch);
+    if (!tree) {
+        return false;
+    }
+
+    /* Solo se recorre el árbol aceptado; los nodos de las alternativas
+    descartadas ya se liberaron al retroceder en la arena.*/
+    visitor->beginOccurrence(format, &grammar.symbolTable(), offset);
+    visitor->walk(tree, offset);
+    visitor->endOccurrence();
+    scratch.clear();
+    return true;
+}
+
+bool Parser::parse(QString *input, ParseResult &scratch,
+                   QVector<ProjectedField> &fields) {
+    AstNode *tree = parse(input, scratch);
+    if (!tree) {
+        return false;
+    }
+
+    projection.collect(tree, fields);
+    scratch.clear();
+    return true;
+}
+
+void Parser::setProjection(const QStringList &names) {
+    this->projection = grammar.project(names);
+}
+
+QStringList Parser::unanalysedRules() const {
+    return grammar.unanalysedRules();
+}
+
+void Parser::releaseRetired() {
+    QMutexLocker locker(&lookaheadMutex);
+    qDeleteAll(retiredLookahead);
+    retiredLookahead.clear();
+}
+
+QVector<RuleStats> Parser::profile() const {
+    return profiler.stats();
+}
+
+QString Parser::profileReport() const {
+    QVector<RuleStats> stats = profiler.stats();
+    QString report;
+    QTextStream out(&report);
+
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+           .arg("rule", -24).arg("class", -14).arg("attempts", 12)
+           .arg("successes", 12).arg("failures", 12).arg("consumed", 14)
+           .arg("nsecs", 16);
+    for (int i = 0; i < stats.size(); ++i) {
+        const RuleStats &entry = stats.at(i);
+        const Rule &rule = grammar.rule(entry.rule);
+        out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg(rule.tagName, -24)
+               .arg(Grammar::className(rule.ruleClass), -14)
+               .arg(entry.attempts, 12).arg(entry.successes, 12)
+               .arg(entry.failures, 12).arg(entry.consumed, 14)
+               .arg(entry.nsecs, 16);
+    }
+    return report;
+}
+
+void Parser::resetProfile() {
+    profiler.reset(grammar.ruleCount());
+}
+
+void Parser::recordLatency(qint64 nsecs, qint64 bytes) {
+    latency.record(nsecs, bytes);
+}
+
+FormatStats Parser::latencyStats() const {
+    return latency.stats(format);
+}
+
+void Parser::resetLatency() {
+    latency.reset();
+}
+
+void Parser::setMemoization(bool enabled, qint64 limit) {
+    this->memoEnabled = enabled;
+    this->memoLimit = limit;
+}
+
+void Parser::setLookaheadEnabled(bool enabled) {
+    this->lookaheadEnabled = enabled;
+}
+
+MemoStats Parser::memoStats() {
+    QMutexLocker locker(&statsMutex);
+    return this->memoTotals;
+}
+
+void Parser::resetMemoStats() {
+    QMutexLocker locker(&statsMutex);
+    this->memoTotals = MemoStats();
+}
+
+void Parser::preloadDictionaries() {
+    for (int i = 0; i < grammar.ruleCount(); ++i) {
+        const Rule &rule = grammar.rule(i);
+        if (rule.ruleClass == RULE_DIC_TERMINAL) {
+            dictManager->getDictionary(rule.tagName);
+        }
+    }
+}
+
+AstNode *Parser::evaluate(QStringRef &textRef, int ruleIndex,
+                          ParseContext &context) {
+
+    if (!context.isMemoEnabled()) {
+        return process(textRef, ruleIndex, context);
+    }
+
+    /* Se busca si la regla ya fue evaluada sobre la misma sección de texto.*/
+    int endPos = textRef.position() + textRef.length();
+    MemoKey key = { ruleIndex, textRef.position(), endPos };
+    MemoEntry entry;
+    if (context.lookup(key, &entry)) {
+        if (!entry.matched) {
+            return NULL;
+        }
+        textRef = QStringRef(textRef.string(), entry.endPosition,
+                             endPos - entry.endPosition);
+        return entry.tree ? entry.tree->clone(context.nodeArena()) : &emptyNode;
+    }
+
+    AstNode *result = process(textRef, ruleIndex, context);
+
+    /* Se guarda una copia del resultado en la arena de memorización si no se
+    sobrepasa el límite de memoria del análisis.*/
+    bool hasTree = result && !result->isNull();
+    qint64 cost = sizeof(MemoKey) + sizeof(MemoEntry);
+    if (hasTree) {
+        cost += result->nodeCount() * qint64(sizeof(AstNode));
+    }
+    if (context.reserve(cost)) {
+        entry.matched = result != NULL;
+        entry.tree = hasTree ? result->clone(context.memoNodeArena()) : NULL;
+        entry.endPosition = textRef.position();
+        context.store(key, entry, cost);
+    }
+
+    return result;
+}
+
+AstNode *Parser::process(QStringRef &textRef, int ruleIndex,
+                         ParseContext &context) {
+#ifdef GENERIC_PARSER_PROFILING
+    QElapsedTimer timer;
+    timer.start();
+    int startPos = textRef.position();
+    AstNode *result = processRule(textRef, ruleIndex, context);
+    bool matched = result && !result->isNull();
+    context.record(ruleIndex, matched, textRef.position() - startPos,
+                   timer.nsecsElapsed());
+    return result;
+#else
+    return processRule(textRef, ruleIndex, context);
+#endif
+}
+
+AstNode *Parser::processRule(QStringRef &textRef, int ruleIndex,
+                             ParseContext &context) {
 
     /* Se obtienen los atributos de la referencia de texto a analizar.*/
     const QString *text = textRef.string();
     int startPos = textRef.position();
     int length = textRef.length();
 
-    /* Se obtienen los valores asociados a la reglas sintácticas.*/
-    QString tagName = subRules.tagName();
-    QString varName = subRules.attribute(ATTR_NAME);
-    QString className = subRules.attribute(ATTR_CLASS);
-    bool required = subRules.attribute(ATTR_REQUIRED) != REQUIRED_FALSE;
+    /* Se obtiene la regla sintáctica compilada.*/
+    const Rule &rule = grammar.rule(ruleIndex);
+    bool required = rule.required;
 
     /* Si la entrada de texto esta vacía.*/
     if (length == 0) {
-        return required ? NULL : new AstNode();
+        return required ? NULL : &emptyNode;
     }
 
-    /* Si el atributo class no esta definido en las reglas.*/
-    if (className.isEmpty()) {
-        qCritical() << "Parser: No se ha definido el atributo " ATTR_CLASS
-                       " para el elemento" << tagName;
-        return NULL;
-    }
+    /* Los nodos se crean en la arena del análisis; al descartar un análisis
+    parcial se retrocede hasta esta marca.*/
+    Arena &arena = context.nodeArena();
+    Arena::Mark mark = arena.mark();
 
     AstNode *result = NULL;
 
+    switch (rule.ruleClass) {
+
     /* Si, según las reglas, se espera encontrar un elemento terminal de la
     gramática.*/
-    if (className == CLASS_REG_TERMINAL || className == CLASS_DIC_TERMINAL) {
+    case RULE_REG_TERMINAL:
+    case RULE_DIC_TERMINAL: {
 
-        QRegExp regexp;
+        int pos = -1;
+        int count = 0;
 
         /* Si se espera encontrar un elemento terminal definido por una
-        expresión regurlar.*/
-        if (className == CLASS_REG_TERMINAL) {
-            QString regexpStr = subRules.attribute(ATTR_REGEXP);
-            if (regexpStr.isEmpty()) {
-                qCritical() << "Parser: No se ha definido el atributo "
-                               ATTR_REGEXP " para el elemento" << tagName;
-                return required ? NULL : new AstNode();
+        expresión regurlar se busca directamente sobre el texto referenciado
+        con la expresión precompilada.*/
+        if (rule.ruleClass == RULE_REG_TERMINAL) {
+            if (rule.matcher.isEmpty() || !rule.matcher.isValid()) {
+                return required ? NULL : &emptyNode;
             }
-            regexp = QRegExp(regexpStr);
-
-            regexp.setMinimal(true);
+            pos = rule.matcher.indexIn(textRef, &count);
 
             /* Si se espera encontrar un elemento terminal definido en
-        diccionario.*/
+            diccionario se busca con el autómata del diccionario.*/
         } else {
-            regexp = dictManager->getDictionary(tagName);
-        }
-
-        /* Se comprueba la validez de la expresión regular.*/
-        if (!regexp.isValid() || regexp.isEmpty()) {
-            qCritical() << "Parser: La expresion regular para el elemento" <<
-                           tagName << "no es correcta";
-            return required ? NULL : new AstNode();
+            const DictionaryMatcher *dictionary =
+                    dictManager->getDictionary(rule.tagName);
+            if (!dictionary) {
+                return required ? NULL : &emptyNode;
+            }
+            pos = dictionary->indexIn(textRef, &count);
         }
 
-        int pos = textRef.toString().indexOf(regexp);
-
         /* Si no coincide el texto analizado con la expresión regular.*/
         if (pos == -1) {
-            return required ? NULL : new AstNode();
+            return required ? NULL : &emptyNode;
         }
 
-        int count = regexp.matchedLength();
         QStringRef tmpRef(text, startPos + pos, count);
-        result = new AstNode(tagName, tmpRef, varName);
+        result = AstNode::create(arena, rule.nodeTag, tmpRef, rule.varId);
 
         /* Se adelanta la referencia de texto hasta la posición siguiente al
         texto reconocido.*/
         int offset = pos + count;
         textRef = QStringRef(text, startPos + offset, length - offset);
+        break;
+    }
 
-        /* Si, según las reglas, se espera encontrar un elemento no terminal de la
+    /* Si, según las reglas, se espera encontrar un elemento no terminal de la
     gramática.*/
-    } else if (className == CLASS_INITIAL || className == CLASS_NON_TERMINAL) {
+    case RULE_INITIAL:
+    case RULE_NON_TERMINAL: {
 
         QStringRef tmpRef = textRef;
 
-        /* Se obtienen el texto de la expresión regular.*/
-        QString regexpStr = subRules.attribute(ATTR_REGEXP);
-        if (regexpStr.isEmpty()) {
-            qCritical() << "Parser: No se ha definido el atributo " ATTR_REGEXP
-                           " para el elemento" << tagName;
-        }
-
-        /* Se genera la expresión regular.*/
-        QRegExp regexp = QRegExp(regexpStr);
-        if (!regexp.isValid()) {
-            qCritical() << "Parser: La expresion regular para el elemento " <<
-                           tagName << "no es correcta";
-            return required ? NULL : new AstNode();
+        /* Se busca con la expresión regular precompilada directamente sobre
+        el texto referenciado.*/
+        if (!rule.matcher.isValid()) {
+            return required ? NULL : &emptyNode;
         }
-        regexp.setMinimal(true);
 
-        int pos = textRef.toString().indexOf(regexp);
+        int count = 0;
+        int pos = rule.matcher.indexIn(textRef, &count);
 
         /* Si no coincide el texto analizado con la expresión regular.*/
         if (pos == -1) {
-            return required ? NULL : new AstNode();
+            return required ? NULL : &emptyNode;
         }
 
         /* Se adelanta la referencia de texto hasta la posición siguiente al
         texto reconocido.*/
-        int count = regexp.matchedLength();
         tmpRef = QStringRef(text, startPos + pos, count);
 
-        /* Si se analiza la primera producción de la gramática se establese como
-        nombre del tag "output".*/
-        if (tagName == format) {
-            result = new AstNode("output", tmpRef);
-        } else {
-            result = new AstNode(tagName, tmpRef, varName);
-        }
+        /* La etiqueta de la primera producción de la gramática ya se ha
+        establecido como "output" al compilar las reglas.*/
+        result = AstNode::create(arena, rule.nodeTag, tmpRef, rule.varId);
 
-        QDomElement cursor = subRules.firstChildElement();
-
-        if (cursor.isNull()) {
+        if (rule.children.isEmpty()) {
             textRef = QStringRef(text, tmpRef.position() + tmpRef.length(),
                                  length - tmpRef.length() - tmpRef.position() + startPos);
             return result;
@@ -210,18 +522,13 @@ AstNode *Parser::process(QStringRef &textRef, QDomElement subRules) {
 
         /* Se analiza el texto con según las reglas definidas para cada
         derivación de la regla*/
-        while (!cursor.isNull()) {
-            AstNode *part = process(tmpRef, cursor);
+        for (int i = 0; i < rule.children.size(); ++i) {
+            AstNode *part = process(tmpRef, rule.children.at(i), context);
             if (!part) {
-                delete result;
-                return required ? NULL : new AstNode();
-            }
-            if (part->isNull()) {
-                delete part;
-            } else {
-                result->addChild(part);
+                arena.rewind(mark);
+                return required ? NULL : &emptyNode;
             }
-            cursor = cursor.nextSiblingElement();
+            result->addChild(part);
         }
 
         /* Se adelanta la referencia de texto hasta la posición siguiente al
@@ -229,68 +536,59 @@ AstNode *Parser::process(QStringRef &textRef, QDomElement subRules) {
         int newPos = tmpRef.position();
         int newLength = length - newPos + startPos;
         textRef = QStringRef(text, newPos, newLength);
+        break;
+    }
 
-        /* Si, según las reglas, se espera encontrar una lista o colección de
+    /* Si, según las reglas, se espera encontrar una lista o colección de
     elementos gramaticales.*/
-    } else if (className == CLASS_LIST || className == CLASS_COLLECTION) {
+    case RULE_LIST:
+    case RULE_COLLECTION: {
 
         QStringRef tmpRef = textRef;
 
         /* Se comprueba la existencia de un hijo para la regla.*/
-        QDomElement elem = subRules.firstChildElement();
-        if (elem.isNull()) {
-            qCritical() << "Parser: No existen hijos para el elemento" <<
-                           tagName;
-            return required ? NULL : new AstNode();
+        if (rule.children.isEmpty()) {
+            return required ? NULL : &emptyNode;
         }
 
         /* Se crea el nodo que se retornará.*/
-        result = new AstNode(tagName, tmpRef, varName);
+        result = AstNode::create(arena, rule.nodeTag, tmpRef, rule.varId);
 
         /* Si se analiza una lista.*/
-        if (className == CLASS_LIST) {
-            AstNode *part = process(tmpRef, elem);
+        if (rule.ruleClass == RULE_LIST) {
+            int elem = rule.children.first();
+            AstNode *part = process(tmpRef, elem, context);
 
             /* Se identifican todos los elementos a listar y se agregan como
             hijos del nodo result.*/
-            while (part) {
-                if (part->isNull()) {
-                    delete part;
-                    part = NULL;
-                } else {
-                    result->addChild(part);
-                    part = process(tmpRef, elem);
-                }
+            while (part && !part->isNull()) {
+                result->addChild(part);
+                part = process(tmpRef, elem, context);
             }
             /* Si se analiza un conjunto de elementos desordenados.*/
         } else {
 
             /* Se identifican todos los elementos a listar por cada categoria
             dentro del conjunto y se agregan como hijos del nodo result.*/
-            while (!elem.isNull()) {
+            for (int i = 0; i < rule.children.size(); ++i) {
+                int elem = rule.children.at(i);
                 QStringRef localRef = textRef;
-                AstNode *part = process(localRef, elem);
-                while (part) {
-                    if (part->isNull()) {
-                        delete part;
-                        part = NULL;
-                    } else {
-                        result->addChild(part);
-                        part = process(localRef, elem);
-                    }
+                AstNode *part = process(localRef, elem, context);
+                while (part && !part->isNull()) {
+                    result->addChild(part);
+                    part = process(localRef, elem, context);
                 }
                 if (localRef.position() > tmpRef.position()) {
                     tmpRef = localRef;
                 }
-                elem = elem.nextSiblingElement();
             }
         }
 
         /* Se comprueba si se ha identificado algún elemento de la lista o
         conjunto.*/
         if (result->childCount() == 0) {
-            delete result;
-            return required ? NULL : new AstNode();
+            arena.rewind(mark);
+            return required ? NULL : &emptyNode;
         }
 
         /* Se adelanta la referencia de texto hasta la posición siguiente al
@@ -298,17 +596,16 @@ AstNode *Parser::process(QStringRef &textRef, QDomElement subRules) {
         int newPos = tmpRef.position();
         int newLength = length - newPos + startPos;
         textRef = QStringRef(text, newPos, newLength);
+        break;
+    }
 
-        /* Si la regla que se ha de procesar es una referencia.*/
-    } else if (className == CLASS_REFERENCE) {
+    /* Si la regla que se ha de procesar es una referencia.*/
+    case RULE_REFERENCE: {
 
         /* Se comprueba la existencia de alguna producción con igual tag que la
         referencia.*/
-        QDomElement cursor = this->rules.firstChildElement(tagName);
-        if (cursor.isNull()) {
-            qCritical() << "Parser: No se pudo encontrar el elemento" <<
-                           tagName;
-            return required ? NULL : new AstNode();
+        if (rule.targets.isEmpty()) {
+            return required ? NULL : &emptyNode;
         }
 
         bool matched = false;
@@ -316,78 +613,83 @@ AstNode *Parser::process(QStringRef &textRef, QDomElement subRules) {
 
         /* Se anliza el texto con cada una de las producciones que tienen el
         mismo tag que la referencia, hasta encontrar una que coincida.*/
-        while (!cursor.isNull() && !matched) {
-            result = process(tmpRef, cursor);
-            if (result) {
-                if (result->isNull()) {
-                    delete result;
-                    result = NULL;
-                } else {
-                    matched = true;
-                    if (!varName.isEmpty()) {
-                        result->setName(varName);
-                    }
+        for (int i = 0; i < rule.targets.size() && !matched; ++i) {
+
+            /* Se descartan las producciones que no pueden comenzar con
+            ninguno de los caracteres del texto.*/
+            if (context.firstCandidate(rule.targets.at(i), tmpRef) == -1) {
+                continue;
+            }
+            result = evaluate(tmpRef, rule.targets.at(i), context);
+            if (result && !result->isNull()) {
+                matched = true;
+                if (rule.varId != -1) {
+                    result->setName(rule.varId);
                 }
+            } else {
+                arena.rewind(mark);
             }
-            cursor = cursor.nextSiblingElement(tagName);
         }
 
         /* Se comprueba si hubo alguna coincidencia.*/
         if (!matched) {
-            return required ? NULL : new AstNode();
+            return required ? NULL : &emptyNode;
         }
 
         /* Se adelanta la referencia de texto hasta la posición siguiente al
         texto reconocido.*/
         textRef = tmpRef;
+        break;
+    }
 
-        /* Si la regla que se ha de procesar es una lista de opciones.*/
-    } else if (className == CLASS_OPTION) {
+    /* Si la regla que se ha de procesar es una lista de opciones.*/
+    case RULE_OPTION: {
 
         /* Se comprueba la existencia de un hijo para la regla.*/
-        QDomElement cursor = subRules.firstChildElement();
-        if (cursor.isNull()) {
-            qCritical() << "Parser: No existen hijos para el elemento" <<
-                           tagName;
-            return required ? NULL : new AstNode();
+        if (rule.children.isEmpty()) {
+            return required ? NULL : &emptyNode;
         }
 
         int pos = startPos + length;
         int len = 0;
 
         /* Se comprueba cual de las opciones esperadas se ecuentra más próxima
-        al inicio del texto analizado.*/
-        while (!cursor.isNull()) {
+        al inicio del texto analizado. Las opciones descartadas son las últimas
+        reservadas en la arena, por lo que se retrocede hasta antes de ellas.*/
+        for (int i = 0; i < rule.children.size(); ++i) {
+
+            /* Se descartan las opciones que no pueden comenzar en el texto y,
+            si su nodo comienza en el primer carácter reconocido, las que no
+            pueden comenzar antes de la opción más próxima encontrada.*/
+            int child = rule.children.at(i);
+            int first = context.firstCandidate(child, textRef);
+            if (first == -1 || (grammar.rule(child).anchored && first > pos)) {
+                continue;
+            }
             QStringRef tmpRef = textRef;
-            AstNode * option = process(tmpRef, cursor);
-            if (option) {
-                if (option->isNull()) {
-                    delete option;
-                } else if ((option->getReference().position() < pos) ||
-                           ((option->getReference().position() == pos) &&
-                            (option->getReference().length() > len))){
-
-                    if (result) {
-                        delete result;
-                    }
-
-                    result = option;
-                    pos = option->getReference().position();
-                    len = option->getReference().length();
-                }
+            Arena::Mark optionMark = arena.mark();
+            AstNode * option = evaluate(tmpRef, child, context);
+            if (option && !option->isNull() &&
+                    ((option->getReference().position() < pos) ||
+                     ((option->getReference().position() == pos) &&
+                      (option->getReference().length() > len)))) {
+                result = option;
+                pos = option->getReference().position();
+                len = option->getReference().length();
+            } else {
+                arena.rewind(optionMark);
             }
-            cursor = cursor.nextSiblingElement();
         }
 
         /* Si pos no se modifica significa que no se encontró ninguna
         coincidencia.*/
         if (pos == startPos + length) {
-            return required ? NULL : new AstNode();
+            return required ? NULL : &emptyNode;
         }
 
         /* Se establese un nombre de variable si ha sido definido.*/
-        if (!varName.isEmpty()) {
-            result->setName(varName);
+        if (rule.varId != -1) {
+            result->setName(rule.varId);
         }
 
         /* Se adelanta la referencia de texto hasta la posición siguiente al
@@ -395,11 +697,23 @@ AstNode *Parser::process(QStringRef &textRef, QDomElement subRules) {
         int newPos = pos + result->getReference().length();
         int newLength = length - newPos + startPos;
         textRef = QStringRef(text, newPos, newLength);
+        break;
+    }
+
+    /* Si el atributo class no esta definido o no se identifica la clase de la
+    regla, los errores ya se han notificado al compilar la gramática.*/
+    default:
+        break;
+    }
 
-        /* Si no se identifica la clase de la regla.*/
-    } else {
-        qCritical() << "Parser: No se pudo reconocer la clase" << className;
+    /* Si ninguno de los descendientes puede tener una variable solicitada, se
+    liberan y el resultado se reduce a su nodo raíz.*/
+    if (result && result->childCount() > 0 && context.prunes(ruleIndex)) {
+        int tag = result->getTagName();
+        int name = result->getName();
+        QStringRef resultRef = result->getReference();
+        arena.rewind(mark);
+        result = AstNode::create(arena, tag, resultRef, name);
     }
     return result;
 }
-
@@ -10,29 +10,32 @@
 #include <QRegExp>
 #include <QHash>
 #include <QDir>
+#include <QMutex>
+#include <QAtomicPointer>
 
-#define DEFAULT_FORMAT "default"
-
-#define ATTR_CLASS "class"
-#define ATTR_REGEXP "regexp"
-#define ATTR_NAME "name"
-#define ATTR_TYPE "type"
-#define ATTR_REQUIRED "required"
-
-#define CLASS_INITIAL "initial"
-#define CLASS_REFERENCE "reference"
-#define CLASS_NON_TERMINAL "non_terminal"
-#define CLASS_REG_TERMINAL "reg_terminal"
-#define CLASS_DIC_TERMINAL "dic_terminal"
-#define CLASS_OPTION "option"
-#define CLASS_LIST "list"
-#define CLASS_COLLECTION "collection"
-
-#define REQUIRED_FALSE "false"
-#define REQUIRED_TRUE "true"
+#include <grammar.h>
+#include <parsecontext.h>
+#include <ruleprofiler.h>
+#include <latencyhistogram.h>
 
 class DictionaryManager;
 class AstNode;
+class ParseResult;
+class ParseVisitor;
+class BatchResult;
+
+/**
+* Primeros caracteres de cada regla, incluidas las primeras letras de los
+* diccionarios en el estado que tenían al calcularlos.
+*/
+struct LookaheadTable
+{
+    /** Generación de los diccionarios con que se calculó la tabla. */
+    int generation;
+
+    /** Primeros caracteres de cada regla, por índice. */
+    QVector<CharSet> sets;
+};
 
 /**
 * Parser es la clase encargada de analizar textos basándose en la sintaxis
@@ -45,12 +48,93 @@ class Parser
         /** Nombre del formato que analiza este parser */
         QString format;
 
-        /** Reglas sintácticas del formato */
-        QDomElement rules;
+        /** Reglas sintácticas del formato compiladas. */
+        Grammar grammar;
 
         /** Gestor de diccionarios */
         DictionaryManager *dictManager;
 
+        /** Indica si se memorizan las referencias y opciones evaluadas. */
+        bool memoEnabled;
+
+        /** Límite de memoria en bytes de la memorización por análisis. */
+        qint64 memoLimit;
+
+        /** Indica si se descartan alternativas según sus primeros caracteres. */
+        bool lookaheadEnabled;
+
+        /** Contadores acumulados de la memorización. */
+        MemoStats memoTotals;
+
+        /** Protege los contadores cuando se analiza desde varios hilos. */
+        QMutex statsMutex;
+
+        /** Variables que se conservan en los árboles resultantes. */
+        Projection projection;
+
+        /**
+        * Evalúa la regla de índice ruleIndex igual que process, consultando
+        * primero la tabla de memorización del contexto y guardando en ella el
+        * resultado si la memorización está activa.
+        * @param textRef referecia al texto a analizar.
+        * @param ruleIndex índice de la regla a evaluar.
+        * @param context estado temporal del análisis.
+        */
+        AstNode* evaluate(QStringRef &textRef, int ruleIndex,
+                          ParseContext &context);
+
+        /** Contadores de evaluación de cada regla. */
+        RuleProfiler profiler;
+
+        /** Tiempos de análisis de las ocurrencias del formato. */
+        LatencyHistogram latency;
+
+        /** Tabla de primeros caracteres publicada, o NULL. */
+        QAtomicPointer<const LookaheadTable> lookahead;
+
+        /** Serializa el cálculo de la tabla de primeros caracteres. */
+        QMutex lookaheadMutex;
+
+        /** Tablas sustituidas que aún pueden estar en uso. */
+        QList<const LookaheadTable *> retiredLookahead;
+
+        /**
+        * Retorna la tabla de primeros caracteres, calculándola de nuevo si
+        * cambiaron los diccionarios desde la última vez.
+        */
+        const LookaheadTable *lookaheadTable();
+
+        /** Libera la tabla publicada y las sustituidas. */
+        void releaseLookahead();
+
+        /**
+        * Prepara context para un análisis cuyos nodos se crean en arena,
+        * estableciendo la proyección y los primeros caracteres de las reglas.
+        */
+        void prepareContext(ParseContext &context, Arena *arena);
+
+        /**
+        * Suma a los totales del parser los contadores de memorización y de
+        * evaluación de reglas registrados en context.
+        */
+        void collectStats(const ParseContext &context);
+
+        /**
+        * Analiza la sección de texto referenciada por text con la producción
+        * inicial. Los nodos de un análisis fallido se liberan de la arena del
+        * contexto.
+        * @return Devuelve la raíz del árbol reconocido o NULL.
+        */
+        AstNode *parseSlice(const QStringRef &text, int start,
+                            ParseContext &context);
+
+        /**
+        * Evalúa la regla de índice ruleIndex. Es el cuerpo de process, que lo
+        * envuelve con los contadores de perfil cuando están compilados.
+        */
+        AstNode* processRule(QStringRef &textRef, int ruleIndex,
+                             ParseContext &context);
+
     public:
 
         /**
@@ -60,6 +144,9 @@ class Parser
         */
         Parser(QDomElement rules, DictionaryManager *dictMgr);
 
+        /** Destructor. */
+        ~Parser();
+
         /** Retorna el nombre del formato de este parser */
         QString getFormat();
 
@@ -67,31 +154,199 @@ class Parser
         void setRules(QDomElement rules);
 
         /** Retorna la expreción regular que identifica el formato del parser */
-        QRegExp matchExp();        
+        QRegExp matchExp();
+
+        /**
+        * Retorna el reconocedor precompilado de la expresión regular que
+        * identifica el formato del parser.
+        */
+        Matcher formatMatcher();
+
+        /**
+        * Retorna el separador de registros del formato, o vacío si sus
+        * ocurrencias se buscan en toda la entrada.
+        * @see Grammar::recordDelimiter
+        */
+        QString recordDelimiter();
 
         /**
         * Analiza una entrada de texto y retorna un árbol sintácticamente
         * organizado según el formato a identificar. Si la sintaxis de la
-        * entrada no es correcta devuelve NULL.
+        * entrada no es correcta devuelve NULL. Los nodos del árbol pertenecen a
+        * result y son válidos mientras este no se vacíe o destruya.
         * @param input puntero a la entrada de texto.
+        * @param result resultado donde se crean los nodos del árbol.
         * @return Devuelve el árbol que representa la estructrua sintáctica
         * reconocida, o NULL si no se reconoce.
         */
-        AstNode* parse(QString *input);
+        AstNode* parse(QString *input, ParseResult &result);
+
+        /**
+        * Analiza la sección de texto referenciada por input sin copiarla. Las
+        * posiciones de los nodos son relativas al texto completo al que
+        * pertenece la referencia. El estado temporal del análisis se toma de
+        * result, por lo que al reutilizar el mismo resultado en análisis
+        * sucesivos no se reserva memoria nueva.
+        * @param input referencia al texto a analizar, debe existir mientras se
+        * use el árbol.
+        * @param result resultado donde se crean los nodos del árbol.
+        * @return Devuelve la raíz del árbol o NULL si no se reconoce.
+        */
+        AstNode* parse(const QStringRef &input, ParseResult &result);
 
         /**
-        * Analiza la sección de la entrada referenciada por textRef con las
-        * reglas sintácticas definidas en subRules. Retorna el árbol resultante
+        * Analiza una entrada de texto y entrega a visitor los eventos de la
+        * estructura reconocida. El árbol se construye en la arena de scratch,
+        * que se vacía al terminar conservando sus bloques para el siguiente
+        * análisis.
+        * @param input puntero a la entrada de texto.
+        * @param scratch resultado temporal donde se crean los nodos.
+        * @param visitor receptor de los eventos.
+        * @param offset posición de la entrada en el texto completo.
+        * @return Devuelve true si se reconoce la entrada.
+        */
+        bool parse(QString *input, ParseResult &scratch, ParseVisitor *visitor,
+                   qint64 offset = 0);
+
+        /**
+        * Analiza cada uno de los registros de records de forma independiente
+        * y agrega sus árboles a batch, que se vacía antes de comenzar. El
+        * estado temporal del análisis se reutiliza entre registros y todos
+        * los nodos se crean en la arena del lote.
+        * @param records registros a analizar, deben existir mientras se use
+        * batch.
+        * @param batch lote donde se agregan los resultados.
+        * @return Devuelve la cantidad de registros reconocidos.
+        */
+        int parse(const QStringList &records, BatchResult &batch);
+
+        /**
+        * Analiza los registros contenidos en buffer igual que la versión que
+        * recibe una lista, sin copiar el texto. Las posiciones de los nodos
+        * son relativas al inicio de buffer.
+        * @param buffer texto que contiene los registros, debe existir mientras
+        * se use batch.
+        * @param offsets posición de inicio de cada registro, en orden
+        * creciente; cada registro termina donde comienza el siguiente y el
+        * último al final de buffer.
+        * @param batch lote donde se agregan los resultados.
+        * @return Devuelve la cantidad de registros reconocidos.
+        */
+        int parse(const QString &buffer, const QVector<int> &offsets,
+                  BatchResult &batch);
+
+        /**
+        * Analiza la sección de la entrada referenciada por textRef con la regla
+        * sintáctica de índice ruleIndex. Retorna el árbol resultante
         * del reconocimento el texto refereciado o NULL si este no coincide con
         * la sintaxis definida. Si se identifica correctamente el texto la
         * referecia textRef es ubicada en el caracter siguiente al texto
         * reconocido.
         * @param textRef referecia al texto a analizar.
-        * @param subRules reglas sintácticas para analizar el texto.
+        * @param ruleIndex índice de la regla compilada con que se analiza el
+        * texto.
+        * @param context estado temporal del análisis.
         * @return Devuelve el arbol de estructural del texto reconocido o NULL
         * si no se reconoce.
         */
-        AstNode* process(QStringRef &textRef, QDomElement subRules);
+        AstNode* process(QStringRef &textRef, int ruleIndex,
+                         ParseContext &context);
+
+        /**
+        * Activa o desactiva la memorización (packrat) de las referencias y
+        * opciones, de forma que cada producción se evalúe a lo sumo una vez por
+        * posición de la entrada.
+        * @param enabled indica si se memorizan los resultados.
+        * @param limit límite aproximado de memoria en bytes por análisis.
+        */
+        void setMemoization(bool enabled, qint64 limit = DEFAULT_MEMO_LIMIT);
+
+        /**
+        * Activa o desactiva el descarte de opciones y producciones según sus
+        * primeros caracteres. Por defecto está activado; desactivarlo solo es
+        * útil para comparar su efecto.
+        */
+        void setLookaheadEnabled(bool enabled);
+
+        /** Retorna los contadores acumulados de la memorización. */
+        MemoStats memoStats();
+
+        /** Reinicia los contadores acumulados de la memorización. */
+        void resetMemoStats();
+
+        /**
+        * Carga los diccionarios que utiliza la gramática, de forma que su
+        * carga no ocurra durante el análisis.
+        */
+        void preloadDictionaries();
+
+        /**
+        * Establece las variables que interesan de los árboles resultantes.
+        * Los subárboles que no pueden contener ninguna de ellas se reducen a
+        * su nodo raíz, sin hijos. Con una lista vacía se construyen los
+        * árboles completos.
+        * @param names nombres de las variables solicitadas.
+        */
+        void setProjection(const QStringList &names);
+
+        /**
+        * Retorna las reglas cuyos primeros caracteres no se pudieron
+        * determinar, por lo que nunca se descartan sin evaluarlas.
+        * @see Grammar::unanalysedRules
+        */
+        QStringList unanalysedRules() const;
+
+        /**
+        * Libera las tablas de primeros caracteres sustituidas al recargar los
+        * diccionarios. Solo se debe invocar cuando no hay análisis en curso
+        * de este parser.
+        */
+        void releaseRetired();
+
+        /**
+        * Retorna los contadores de evaluación de las reglas, ordenados de
+        * mayor a menor tiempo acumulado. Solo se registran si la biblioteca se
+        * compila con GENERIC_PARSER_PROFILING.
+        */
+        QVector<RuleStats> profile() const;
+
+        /**
+        * Retorna un informe en texto de los contadores de evaluación, con una
+        * línea por regla que indica su etiqueta y clase.
+        */
+        QString profileReport() const;
+
+        /**
+        * Reinicia los contadores de evaluación. No se debe invocar mientras se
+        * analiza.
+        */
+        void resetProfile();
+
+        /**
+        * Registra el tiempo de análisis de una ocurrencia del formato. Se
+        * puede invocar desde varios hilos.
+        * @param nsecs tiempo de análisis en nanosegundos.
+        * @param bytes longitud en bytes UTF-8 de la ocurrencia.
+        */
+        void recordLatency(qint64 nsecs, qint64 bytes);
+
+        /** Retorna el resumen de los tiempos de análisis del formato. */
+        FormatStats latencyStats() const;
+
+        /** Elimina los tiempos de análisis registrados. */
+        void resetLatency();
+
+        /**
+        * Analiza una entrada de texto y agrega a fields las variables
+        * solicitadas con setProjection que se reconocen, con su posición en
+        * input. Los nodos se crean en scratch, que se vacía al terminar.
+        * @param input puntero a la entrada de texto.
+        * @param scratch resultado temporal donde se crean los nodos.
+        * @param fields variables encontradas.
+        * @return Devuelve true si se reconoce la entrada.
+        */
+        bool parse(QString *input, ParseResult &scratch,
+                   QVector<ProjectedField> &fields);
 };
 
 #endif
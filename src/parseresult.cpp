@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <parseresult.h>
+#include <astnode.h>
+#include <symboltable.h>
+
+ParseResult::ParseResult() {
+    this->rootNode = NULL;
+    this->symbols = NULL;
+    this->indexed = false;
+}
+
+AstNode *ParseResult::root() const {
+    return this->rootNode;
+}
+
+void ParseResult::setRoot(AstNode *root) {
+    this->rootNode = root;
+    this->indexed = false;
+}
+
+bool ParseResult::isNull() const {
+    return rootNode == NULL;
+}
+
+void ParseResult::clear() {
+    rootNode = NULL;
+    indexed = false;
+    arena.clear();
+}
+
+Arena &ParseResult::nodeArena() {
+    return this->arena;
+}
+
+ParseContext &ParseResult::context() {
+    return this->scratch;
+}
+
+const SymbolTable *ParseResult::symbolTable() const {
+    return this->symbols;
+}
+
+void ParseResult::setSymbolTable(const SymbolTable *symbols) {
+    this->symbols = symbols;
+    this->indexed = false;
+}
+
+void ParseResult::indexNode(AstNode *node) {
+    int id = node->getName();
+    if (id >= 0 && id < nameIndex.size() && !nameIndex.at(id)) {
+        nameIndex[id] = node;
+    }
+    for (AstNode *child = node->getFirstChild(); child;
+         child = child->getNextSibling()) {
+        indexNode(child);
+    }
+}
+
+AstNode *ParseResult::findName(int id) {
+    if (!rootNode || !symbols || id < 0 || id >= symbols->size()) {
+        return NULL;
+    }
+
+    /* Se construye el índice de nombres recorriendo el árbol una sola vez.*/
+    if (!indexed) {
+        nameIndex.fill(NULL, symbols->size());
+        indexNode(rootNode);
+        indexed = true;
+    }
+    return nameIndex.at(id);
+}
+
+AstNode *ParseResult::findName(const QString &name) {
+    return symbols ? findName(symbols->id(name)) : NULL;
+}
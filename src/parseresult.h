@@ -0,0 +1,102 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef PARSERESULT_H
+#define PARSERESULT_H
+
+#include <QString>
+#include <QVector>
+
+#include <arena.h>
+#include <parsecontext.h>
+
+class AstNode;
+class SymbolTable;
+
+/**
+* ParseResult es el propietario del árbol obtenido al analizar una entrada.
+* Todos los nodos se reservan en su arena, por lo que al destruir o vaciar el
+* resultado se liberan de una vez, sin recorrer el árbol. Un mismo ParseResult
+* puede reutilizarse en análisis sucesivos conservando la memoria reservada.
+*/
+class ParseResult
+{
+    private:
+
+        /** Arena donde se reservan los nodos del árbol. */
+        Arena arena;
+
+        /** Raíz del árbol reconocido o NULL. */
+        AstNode *rootNode;
+
+        /** Tabla de símbolos de la gramática que generó el árbol. */
+        const SymbolTable *symbols;
+
+        /**
+        * Primer nodo, en orden de aparición, con cada nombre de variable,
+        * indexado por identificador de símbolo.
+        */
+        QVector<AstNode *> nameIndex;
+
+        /** Indica si el índice de nombres corresponde al árbol actual. */
+        bool indexed;
+
+        /** Estado temporal de los análisis, que se reutiliza entre ellos. */
+        ParseContext scratch;
+
+        /** Agrega al índice de nombres los nodos del árbol cuya raíz es node. */
+        void indexNode(AstNode *node);
+
+        ParseResult(const ParseResult &);
+        ParseResult &operator=(const ParseResult &);
+
+    public:
+
+        /** Constructor. */
+        ParseResult();
+
+        /** Retorna la raíz del árbol reconocido o NULL si no se reconoció. */
+        AstNode *root() const;
+
+        /** Establece la raíz del árbol reconocido. */
+        void setRoot(AstNode *root);
+
+        /** Retorna si no se ha reconocido ningún árbol. */
+        bool isNull() const;
+
+        /** Descarta el árbol conservando la memoria para reutilizarla. */
+        void clear();
+
+        /** Retorna la arena donde se reservan los nodos. */
+        Arena &nodeArena();
+
+        /**
+        * Retorna el estado temporal con que se analiza sobre este resultado.
+        * Conserva la memoria de la tabla de memorización entre análisis.
+        */
+        ParseContext &context();
+
+        /** Retorna la tabla de símbolos de la gramática que generó el árbol. */
+        const SymbolTable *symbolTable() const;
+
+        /** Establece la tabla de símbolos de la gramática que genera el árbol. */
+        void setSymbolTable(const SymbolTable *symbols);
+
+        /**
+        * Retorna el primer nodo, en orden de aparición, cuyo nombre de
+        * variable tiene el identificador id, o NULL si no existe. El índice se
+        * construye en la primera consulta, las siguientes son de tiempo
+        * constante.
+        */
+        AstNode *findName(int id);
+
+        /**
+        * Retorna el primer nodo, en orden de aparición, cuyo nombre de
+        * variable es name, o NULL si no existe.
+        */
+        AstNode *findName(const QString &name);
+};
+
+#endif // PARSERESULT_H
@@ -5,16 +5,34 @@
 
 #include <QDebug>
 #include <QDir>
-#include <QTime>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QBuffer>
+#include <QFuture>
+#include <QtConcurrentRun>
 
 #include <parsermanager.h>
 #include <parser.h>
 #include <astnode.h>
+#include <parseresult.h>
+#include <batchresult.h>
+#include <domsink.h>
+#include <xmlstreamsink.h>
+#include <jsonsink.h>
+#include <binarysink.h>
+#include <visitorsink.h>
+#include <formatscanner.h>
+#include <streamreader.h>
+#include <mappedreader.h>
 #include <dictionarymanager.h>
 
 ParserManager::ParserManager(QDir confDir)
 {
     configDirectory = confDir;
+    streamChunk = DEFAULT_STREAM_CHUNK;
+    streamLimit = DEFAULT_STREAM_LIMIT;
+    workerCount = 1;
+    concurrentFormats = false;
     dictionaries = new DictionaryManager(confDir);
 
     /* Se buscan todos los archivos *.xml en el directorio de configuración.*/
@@ -96,39 +114,220 @@ bool ParserManager::configureParser(QString format)
     return true;
 }
 
-int ParserManager::parseFormat(QString *input, QDomDocument &doc, int parserPos)
+bool ParserManager::emitOccurrence(int parserPos, const QString &input,
+                                   int pos, int length, qint64 offset,
+                                   qint64 byteOffset, ParseResult &result,
+                                   OutputSink *sink)
+{
+    Parser * formatParser = parserList.at(parserPos);
+    QElapsedTimer timer;
+    timer.start();
+
+    /* La ocurrencia se analiza en su lugar dentro de la entrada, sin
+    copiarla.*/
+    QStringRef formatOcur(&input, pos, length);
+    AstNode * tree = formatParser->parse(formatOcur, result);
+    qint64 nsecs = timer.nsecsElapsed();
+
+    /* Solo se entregan las ocurrencias de las que se obtiene un árbol de
+    sintaxis correctamente formado.*/
+    if (!tree) {
+        return false;
+    }
+
+    Occurrence ocur;
+    ocur.format = formatParser->getFormat();
+    ocur.input = formatOcur;
+    ocur.offset = offset;
+    ocur.byteOffset = byteOffset;
+    ocur.tree = tree;
+    ocur.symbols = result.symbolTable();
+    ocur.nsecs = nsecs;
+    formatParser->recordLatency(nsecs, InputReader::utf8Length(ocur.input));
+    sink->occurrence(ocur);
+    return true;
+}
+
+/**
+* Ocurrencia de un formato que se analiza en uno de los hilos de trabajo.
+*/
+struct ParseJob
+{
+    /** Posición de la ocurrencia en la entrada. */
+    int position;
+
+    /** Longitud de la ocurrencia. */
+    int length;
+
+    /** Resultado donde se construye el árbol. */
+    ParseResult *result;
+
+    /** Árbol obtenido o NULL si la sintaxis no es correcta. */
+    AstNode *tree;
+
+    /** Tiempo de análisis en nanosegundos. */
+    qint64 nsecs;
+};
+
+/**
+* Lote de ocurrencias que se reparte entre los hilos de trabajo.
+*/
+struct ParseBatch
+{
+    /** Parser del formato. */
+    Parser *parser;
+
+    /** Entrada de texto, solo se lee. */
+    const QString *input;
+
+    /** Ocurrencias del lote. */
+    ParseJob *jobs;
+
+    /** Cantidad de ocurrencias del lote. */
+    int count;
+
+    /** Cantidad de hilos entre los que se reparte el lote. */
+    int step;
+};
+
+/**
+* Analiza las ocurrencias del lote cuyo índice es first, first + step, ...
+* Cada hilo escribe solo en sus propias ocurrencias y resultados.
+*/
+static void parseJobs(ParseBatch batch, int first)
+{
+    for (int i = first; i < batch.count; i += batch.step) {
+        ParseJob &job = batch.jobs[i];
+        QElapsedTimer timer;
+        timer.start();
+        QStringRef text(batch.input, job.position, job.length);
+        job.tree = batch.parser->parse(text, *job.result);
+        job.nsecs = timer.nsecsElapsed();
+    }
+}
+
+int ParserManager::parseFormatParallel(QString *input, OutputSink *sink,
+                                       int parserPos)
 {
     int formatCount = 0;
     Parser * formatParser = parserList.at(parserPos);
-    QRegExp formatExp = formatParser->matchExp();
+    Matcher formatExp = formatParser->formatMatcher();
+    QString delimiter = formatParser->recordDelimiter();
+
+    if (formatExp.isEmpty() || !formatExp.isValid()) {
+        return 0;
+    }
+
+    /* Los diccionarios se cargan antes de repartir el trabajo, de forma que
+    ningún hilo tenga que esperar por su carga.*/
+    formatParser->preloadDictionaries();
+
+    /* Cada posición del lote conserva su resultado entre lotes para reutilizar
+    los bloques de su arena.*/
+    int batchSize = workerCount * PARALLEL_BATCH;
+    QVector<ParseJob> jobs;
+    QVector<ParseResult *> results;
+    jobs.reserve(batchSize);
+
+    int pos = 0;
+    int n = 0;
+    bool finished = false;
+
+    while (!finished) {
+
+        /* Se localiza el siguiente lote de ocurrencias del formato.*/
+        jobs.clear();
+        while (jobs.size() < batchSize) {
+            pos = delimiter.isEmpty() ?
+                        formatExp.indexIn(*input, pos, &n) :
+                        FormatScanner::findRecord(formatExp, delimiter, *input, pos, &n);
+            if (pos == -1 || n <= 0) {
+                finished = true;
+                break;
+            }
+            if (results.size() == jobs.size()) {
+                results.append(new ParseResult);
+            }
+            ParseJob job;
+            job.position = pos;
+            job.length = n;
+            job.result = results.at(jobs.size());
+            job.tree = NULL;
+            job.nsecs = 0;
+            jobs.append(job);
+            pos += n;
+        }
+        if (jobs.isEmpty()) {
+            break;
+        }
+
+        /* Se reparten las ocurrencias entre los hilos y se espera a que
+        terminen todos.*/
+        ParseBatch batch;
+        batch.parser = formatParser;
+        batch.input = input;
+        batch.jobs = jobs.data();
+        batch.count = jobs.size();
+        batch.step = qMin(workerCount, jobs.size());
+
+        QList<QFuture<void> > tasks;
+        for (int t = 0; t < batch.step; ++t) {
+            tasks.append(QtConcurrent::run(&workerPool, parseJobs, batch, t));
+        }
+        for (int t = 0; t < tasks.size(); ++t) {
+            tasks[t].waitForFinished();
+        }
+
+        /* Los resultados se entregan en el orden de la entrada, igual que en
+        el análisis secuencial.*/
+        for (int i = 0; i < jobs.size(); ++i) {
+            const ParseJob &job = jobs.at(i);
+            if (!job.tree) {
+                continue;
+            }
+            Occurrence ocur;
+            ocur.format = formatParser->getFormat();
+            ocur.input = QStringRef(input, job.position, job.length);
+            ocur.offset = job.position;
+            ocur.byteOffset = -1;
+            ocur.tree = job.tree;
+            ocur.symbols = job.result->symbolTable();
+            ocur.nsecs = job.nsecs;
+            formatParser->recordLatency(job.nsecs,
+                                        InputReader::utf8Length(ocur.input));
+            sink->occurrence(ocur);
+            formatCount++;
+        }
+    }
+
+    qDeleteAll(results);
+    return formatCount;
+}
+
+int ParserManager::parseFormat(QString *input, OutputSink *sink, int parserPos)
+{
+    if (workerCount > 1) {
+        return parseFormatParallel(input, sink, parserPos);
+    }
+
+    int formatCount = 0;
+    Parser * formatParser = parserList.at(parserPos);
+    Matcher formatExp = formatParser->formatMatcher();
+    QString delimiter = formatParser->recordDelimiter();
 
     if (!formatExp.isEmpty() && formatExp.isValid()) {
         int pos = 0;
         int n = 0;
+        ParseResult result;
 
         /* Se separa cada ocurrencia del formato dentro de la entrada de
-        texto.*/
-        while ((pos = input->indexOf(formatExp, pos)) != -1 &&
-               (n = formatExp.matchedLength()) > 0) {
-
-            QTime start = QTime::currentTime();
-
-            QString formatOcur(input->mid(pos, n));
-            AstNode * tree = formatParser->parse(&formatOcur);
-
-            /* Si se obtiene un árbol de sintaxis correctamente formado, su
-            estructura es agregada al resultado final.*/
-            if (tree) {
-                QDomElement ocurElem = doc.createElement(
-                            formatParser->getFormat());
-                doc.documentElement().appendChild(ocurElem);
-                QDomElement frmtInput = doc.createElement("inputdata");
-                frmtInput.appendChild(doc.createTextNode(formatOcur));
-                ocurElem.appendChild(frmtInput);
-                QDomElement frmtOutput = tree->toDom(&doc);
-                frmtOutput.setAttribute("milisecs", start.msecsTo(QTime::currentTime()));
-                ocurElem.appendChild(frmtOutput);
-                delete tree;
+        texto, o dentro de cada registro si el formato los define.*/
+        while ((pos = delimiter.isEmpty() ?
+                formatExp.indexIn(*input, pos, &n) :
+                FormatScanner::findRecord(formatExp, delimiter, *input, pos, &n)) != -1 &&
+               n > 0) {
+            if (emitOccurrence(parserPos, *input, pos, n, pos, -1, result,
+                               sink)) {
                 formatCount++;
             }
             pos += n;
@@ -137,6 +336,13 @@ int ParserManager::parseFormat(QString *input, QDomDocument &doc, int parserPos)
     return formatCount;
 }
 
+int ParserManager::parseFormat(QString *input, QDomDocument &doc, int parserPos)
+{
+    DomSink sink(doc);
+    sink.begin();
+    return parseFormat(input, &sink, parserPos);
+}
+
 int ParserManager::parseFormat(QString *input, QDomDocument &doc, QString format)
 {
     int pos = findParser(format);
@@ -152,96 +358,492 @@ int ParserManager::parseFormat(QString *input, QDomDocument &doc, QString format
     return parseFormat(input, doc, pos);
 }
 
+int ParserManager::parseRecords(QString format, const QStringList &records,
+                                BatchResult &batch)
+{
+    int pos = findParser(format);
+    if (pos == -1) {
+        qCritical() << QObject::trUtf8(
+                           "Parser: No se puedo encontrar un parser para el formato %1.").arg(
+                           format);
+        return -1;
+    }
+
+    return parserList.at(pos)->parse(records, batch);
+}
+
+int ParserManager::parseRecords(QString format, const QString &buffer,
+                                const QVector<int> &offsets, BatchResult &batch)
+{
+    int pos = findParser(format);
+    if (pos == -1) {
+        qCritical() << QObject::trUtf8(
+                           "Parser: No se puedo encontrar un parser para el formato %1.").arg(
+                           format);
+        return -1;
+    }
+
+    return parserList.at(pos)->parse(buffer, offsets, batch);
+}
+
+QDomDocument ParserManager::formatDocument(QString *input, int parserPos)
+{
+    QDomDocument doc;
+    DomSink sink(doc);
+    sink.begin();
+    parseFormat(input, &sink, parserPos);
+    return doc;
+}
+
 QDomDocument ParserManager::toDom(QString *input)
 {
     /* Se crean el documento DOM y su elemento raíz donde se almacenará el
     resultado final.*/
     QDomDocument doc;
-    QDomElement root = doc.createElement("xml");
-    doc.appendChild(root);
+    DomSink sink(doc);
+    sink.begin();
+
+    if (concurrentFormats && parserList.size() > 1) {
+
+        /* Los diccionarios se cargan antes de repartir los formatos, de forma
+        que ningún hilo tenga que esperar por su carga.*/
+        for (int i = 0; i < parserList.size(); ++i) {
+            parserList.at(i)->preloadDictionaries();
+        }
+
+        /* Cada formato se analiza en su propio hilo y documento.*/
+        formatPool.setMaxThreadCount(parserList.size());
+        QList<QFuture<QDomDocument> > passes;
+        for (int i = 0; i < parserList.size(); ++i) {
+            passes.append(QtConcurrent::run(&formatPool, this,
+                                            &ParserManager::formatDocument,
+                                            input, i));
+        }
+
+        /* Las ocurrencias se agregan en el orden de los formatos, igual que
+        en el análisis secuencial: se espera por cada formato en ese orden,
+        aunque alguno posterior haya terminado antes.*/
+        QDomElement root = doc.documentElement();
+        for (int i = 0; i < passes.size(); ++i) {
+            QDomElement partRoot = passes[i].result().documentElement();
+            for (QDomNode child = partRoot.firstChild(); !child.isNull();
+                 child = child.nextSibling()) {
+                root.appendChild(doc.importNode(child, true));
+            }
+        }
+
+        sink.end();
+        return doc;
+    }
 
     /* Se procesa la entrada de texto con cada uno de los analizadores
     sintácicos disponibles.*/
     for (int i = 0; i < parserList.size(); ++i) {
-        parseFormat(input, doc, i);
+        parseFormat(input, &sink, i);
     }
 
+    sink.end();
     return doc;
 }
 
+void ParserManager::parseAll(QString *input, OutputSink *sink)
+{
+    int startpos = 0;
+    ParseResult result;
+
+    /* Las expresiones de todos los formatos se reúnen en un solo reconocedor
+    que recorre la entrada una vez.*/
+    FormatScanner scanner;
+    for (int i = 0; i < parserList.size(); ++i) {
+        scanner.addFormat(parserList.at(i)->formatMatcher(),
+                          parserList.at(i)->recordDelimiter());
+    }
+
+    sink->begin();
+    do {
+        int formatpos = -1;
+        int majlength = 0;
+        int minpos = scanner.next(*input, startpos, &formatpos, &majlength);
+
+        if (minpos == -1) {
+            sink->unknown(input->midRef(startpos), startpos);
+            break;
+        }
+
+        if (minpos > startpos) {
+            sink->unknown(input->midRef(startpos, minpos - startpos), startpos);
+        }
+
+        emitOccurrence(formatpos, *input, minpos, majlength, minpos, -1,
+                       result, sink);
+
+        startpos = minpos + majlength;
+    } while (true);
+    sink->end();
+}
+
 QDomDocument ParserManager::parseAll(QString *input)
 {
     /* Se crean el documento DOM y su elemento raíz donde se almacenará el
     resultado final.*/
     QDomDocument doc;
-    QDomElement root = doc.createElement("xml");
-    doc.appendChild(root);
+    DomSink sink(doc);
+    parseAll(input, &sink);
+    return doc;
+}
+
+/**
+* Última búsqueda de un formato durante el análisis de un flujo.
+*/
+struct ScanCandidate
+{
+    /** Reconocedor del formato. */
+    Matcher matcher;
+
+    /** Separador de registros del formato, o vacío. */
+    QString delimiter;
+
+    /** Indica si el formato ya se buscó en el buffer. */
+    bool searched;
+
+    /** Posición de la coincidencia en el buffer o -1 si no existe. */
+    int position;
+
+    /** Longitud de la coincidencia. */
+    int length;
+
+    /** Indica si la coincidencia es parcial. */
+    bool partial;
+
+    /** Longitud del buffer al realizar la búsqueda. */
+    int bufferLength;
 
+    /** Indica si la búsqueda consideró que la entrada estaba completa. */
+    bool complete;
+};
+
+int ParserManager::scan(InputReader &reader, OutputSink *sink)
+{
+    /* El buffer contiene la parte de la entrada que aún no se ha procesado.
+    base es la posición de su primer caracter en la entrada completa, startpos
+    el inicio del texto pendiente, startByte su posición en bytes y searchpos
+    la primera posición donde aún puede comenzar una ocurrencia.*/
+    QString buffer;
+    qint64 base = 0;
+    qint64 startByte = reader.startByte();
     int startpos = 0;
+    int searchpos = 0;
+    int formatCount = 0;
+    bool atEnd = false;
+    bool needMore = false;
+    bool forced = false;
+    ParseResult result;
+
+    /* Los reconocedores se obtienen una sola vez y cada formato conserva su
+    última búsqueda, de forma que un formato poco frecuente no se vuelve a
+    buscar en todo el texto pendiente tras cada ocurrencia de otro.*/
+    QVector<ScanCandidate> candidates;
+    for (int i = 0; i < parserList.size(); ++i) {
+        ScanCandidate candidate;
+        candidate.matcher = parserList.at(i)->formatMatcher();
+        candidate.delimiter = parserList.at(i)->recordDelimiter();
+        candidate.searched = false;
+        candidate.position = -1;
+        candidate.length = 0;
+        candidate.partial = false;
+        candidate.bufferLength = 0;
+        candidate.complete = false;
+        candidates.append(candidate);
+    }
 
+    sink->begin();
     do {
+        /* Se lee un nuevo bloque cuando el texto pendiente es menor que el
+        tamaño de bloque o no alcanza para decidir la siguiente ocurrencia.*/
+        if (!atEnd && (needMore || buffer.length() - startpos < streamChunk)) {
+            buffer.append(reader.read(streamChunk));
+            atEnd = reader.atEnd();
+        }
+        needMore = false;
+
+        bool complete = atEnd || forced;
+        forced = false;
+
         int formatpos = -1;
-        int minpos = input->length();
+        int minpos = buffer.length();
         int majlength = 0;
+        int partialpos = buffer.length();
 
-        for (int i = 0; i < parserList.size(); ++i) {
-            QRegExp formatExp = parserList.at(i)->matchExp();
-            if (formatExp.isEmpty() || !formatExp.isValid()) {
+        for (int i = 0; i < candidates.size(); ++i) {
+            ScanCandidate &candidate = candidates[i];
+            if (candidate.matcher.isEmpty() || !candidate.matcher.isValid()) {
+                continue;
+            }
+
+            /* Una coincidencia completa encontrada sin forzar el final de la
+            entrada no cambia al leer más texto, por lo que solo se busca de
+            nuevo cuando ya comienza antes de searchpos. Las coincidencias
+            parciales, la ausencia de coincidencia y las búsquedas forzadas
+            se repiten solo si cambió el texto o el modo de búsqueda.*/
+            bool definitive = candidate.position >= 0 && !candidate.partial &&
+                    (!candidate.complete || atEnd);
+            bool research = !candidate.searched ||
+                    (candidate.position >= 0 && candidate.position < searchpos) ||
+                    (!definitive && (candidate.bufferLength != buffer.length() ||
+                                     candidate.complete != complete));
+            if (research) {
+
+                /* Mientras la entrada puede continuar, una coincidencia que
+                alcanza el final del buffer es parcial: con más texto podría
+                ser más larga o comenzar en otra posición. Los formatos
+                orientados a registros no analizan el último registro hasta
+                que aparece su separador.*/
+                candidate.length = 0;
+                candidate.partial = false;
+                if (!candidate.delimiter.isEmpty()) {
+                    candidate.position = FormatScanner::findRecord(
+                                candidate.matcher, candidate.delimiter, buffer,
+                                searchpos, &candidate.length,
+                                complete ? NULL : &candidate.partial);
+                } else {
+                    candidate.position = complete ?
+                                candidate.matcher.indexIn(buffer, searchpos,
+                                                          &candidate.length) :
+                                candidate.matcher.indexIn(buffer, searchpos,
+                                                          &candidate.length,
+                                                          &candidate.partial);
+                }
+                candidate.searched = true;
+                candidate.bufferLength = buffer.length();
+                candidate.complete = complete;
+            }
+
+            int pos = candidate.position;
+            int length = candidate.length;
+            bool partial = candidate.partial;
+            if (pos < 0) {
                 continue;
             }
-            int pos = input->indexOf(formatExp, startpos);
-            int length = formatExp.matchedLength();
-            if (pos >= 0 && ((pos < minpos) || (pos == minpos && length > majlength))) {
+            if (partial) {
+                partialpos = qMin(partialpos, pos);
+            } else if (length > 0 && ((pos < minpos) ||
+                                      (pos == minpos && length > majlength))) {
                 formatpos = i;
                 minpos = pos;
                 majlength = length;
             }
         }
 
-        if (formatpos == -1 ) {
-            QDomElement unknow = doc.createElement("unknow");
-            unknow.appendChild(doc.createTextNode(input->mid(startpos)));
-            doc.documentElement().appendChild(unknow);
+        /* Antes de searchpos ya no puede comenzar ninguna ocurrencia, por lo
+        que la búsqueda continúa desde ese punto al leer más texto.*/
+        searchpos = qMin(minpos, partialpos);
+
+        if (formatpos != -1 && minpos < partialpos) {
+            if (minpos > startpos) {
+                QStringRef gap = buffer.midRef(startpos, minpos - startpos);
+                sink->unknown(gap, base + startpos);
+                startByte += InputReader::utf8Length(gap);
+            }
+            if (emitOccurrence(formatpos, buffer, minpos, majlength,
+                               base + minpos, startByte, result, sink)) {
+                formatCount++;
+            }
+            startByte += InputReader::utf8Length(buffer.midRef(minpos,
+                                                               majlength));
+            startpos = minpos + majlength;
+            searchpos = startpos;
+
+        } else if (atEnd) {
+            if (buffer.length() > startpos) {
+                sink->unknown(buffer.midRef(startpos), base + startpos);
+            }
             break;
+
+        } else if (buffer.length() - startpos >= streamLimit) {
+
+            /* Al alcanzar el límite de memoria se entrega como no reconocido
+            el texto anterior a la primera coincidencia parcial. Si esta
+            comienza en el texto pendiente, la ocurrencia se decide con el
+            texto disponible, como si la entrada terminara en ese punto.*/
+            if (searchpos > startpos) {
+                QStringRef gap = buffer.midRef(startpos, searchpos - startpos);
+                sink->unknown(gap, base + startpos);
+                startByte += InputReader::utf8Length(gap);
+                startpos = searchpos;
+            } else {
+                forced = true;
+            }
+
+        } else {
+            needMore = true;
         }
 
-        if (minpos > startpos) {
-            QDomElement unknow = doc.createElement("unknow");
-            unknow.appendChild(doc.createTextNode(input->mid(startpos, minpos - startpos)));
-            doc.documentElement().appendChild(unknow);
+        /* Se descarta el texto procesado, conservando el caracter anterior
+        para que los límites de palabra se evalúen correctamente y, en los
+        formatos orientados a registros, el separador anterior al registro
+        actual para que su inicio se siga reconociendo.*/
+        int drop = 0;
+        if (startpos > streamChunk && startpos > buffer.length() / 2) {
+            drop = startpos - 1;
+            for (int i = 0; i < candidates.size(); ++i) {
+                const QString &delimiter = candidates.at(i).delimiter;
+                if (!delimiter.isEmpty()) {
+                    drop = qMin(drop, FormatScanner::recordStart(
+                                    delimiter, buffer, searchpos) -
+                                delimiter.length());
+                }
+            }
         }
+        if (drop > 0) {
+            buffer.remove(0, drop);
+            base += drop;
+            startpos -= drop;
+            searchpos -= drop;
+            for (int i = 0; i < candidates.size(); ++i) {
+                ScanCandidate &candidate = candidates[i];
+                if (candidate.position >= 0) {
+                    candidate.position -= drop;
+                }
+                candidate.bufferLength -= drop;
+            }
+        }
+    } while (true);
+    sink->end();
 
-        QTime start = QTime::currentTime();
+    return formatCount;
+}
 
-        QString formatOcur(input->mid(minpos, majlength));
-        AstNode * tree = parserList[formatpos]->parse(&formatOcur);
+int ParserManager::parseStream(QIODevice *device, OutputSink *sink)
+{
+    StreamReader reader(device);
+    return scan(reader, sink);
+}
 
-        /* Si se obtiene un árbol de sintaxis correctamente formado, su
-        estructura es agregada al resultado final.*/
-        if (tree) {
-            QDomElement ocurElem = doc.createElement(parserList[formatpos]->getFormat());
-            doc.documentElement().appendChild(ocurElem);
-            QDomElement frmtInput = doc.createElement("inputdata");
-            frmtInput.appendChild(doc.createTextNode(formatOcur));
-            ocurElem.appendChild(frmtInput);
-            QDomElement frmtOutput = tree->toDom(&doc);
-            frmtOutput.setAttribute("milisecs", start.msecsTo(QTime::currentTime()));
-            ocurElem.appendChild(frmtOutput);
-            delete tree;
-        }
+int ParserManager::parseFile(QString path, OutputSink *sink)
+{
+    /* El fichero se proyecta en memoria y se decodifica por bloques. Si no se
+    puede proyectar se lee como un flujo.*/
+    MappedReader mapped(path);
+    if (mapped.map()) {
+        return scan(mapped, sink);
+    }
 
-        startpos = minpos + majlength;
-    } while (true);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << QObject::trUtf8(
+                           "Parser: No se puedo abrir el fichero %1.").arg(path);
+        return -1;
+    }
+    return parseStream(&file, sink);
+}
 
-    return doc;
+void ParserManager::setWorkerCount(int count)
+{
+    if (count < 1) {
+        count = QThread::idealThreadCount();
+    }
+    this->workerCount = qMax(1, count);
+    workerPool.setMaxThreadCount(workerCount);
+}
+
+int ParserManager::getWorkerCount()
+{
+    return this->workerCount;
+}
+
+void ParserManager::setConcurrentFormats(bool enabled)
+{
+    this->concurrentFormats = enabled;
+}
+
+void ParserManager::setProjection(const QStringList &names)
+{
+    for (int i = 0; i < parserList.size(); ++i) {
+        parserList.at(i)->setProjection(names);
+    }
+}
+
+QList<FormatStats> ParserManager::formatStats()
+{
+    QList<FormatStats> result;
+    for (int i = 0; i < parserList.size(); ++i) {
+        result.append(parserList.at(i)->latencyStats());
+    }
+    return result;
+}
+
+void ParserManager::resetStats()
+{
+    for (int i = 0; i < parserList.size(); ++i) {
+        parserList.at(i)->resetLatency();
+    }
+}
+
+void ParserManager::setStreamLimits(int chunkSize, int memoryLimit)
+{
+    this->streamChunk = qMax(1, chunkSize);
+    this->streamLimit = qMax(streamChunk, memoryLimit);
+}
+
+void ParserManager::toSink(QString *input, OutputSink *sink) {
+    sink->begin();
+
+    /* Se procesa la entrada de texto con cada uno de los analizadores
+    sintácicos disponibles, entregando cada ocurrencia al reconocerla.*/
+    for (int i = 0; i < parserList.size(); ++i) {
+        parseFormat(input, sink, i);
+    }
+
+    sink->end();
+}
+
+void ParserManager::toVisitor(QString *input, ParseVisitor *visitor) {
+    VisitorSink sink(visitor);
+    toSink(input, &sink);
+}
+
+void ParserManager::toXml(QString *input, QIODevice *device) {
+    XmlStreamSink sink(device);
+    toSink(input, &sink);
+}
+
+void ParserManager::toJson(QString *input, QIODevice *device) {
+    JsonSink sink(device);
+    toSink(input, &sink);
+}
+
+void ParserManager::toBinary(QString *input, QIODevice *device) {
+    BinarySink sink(device);
+    toSink(input, &sink);
 }
 
 QByteArray ParserManager::toXml(QString *input) {
-    return toDom(input).toByteArray();
+    QByteArray xml;
+    QBuffer buffer(&xml);
+    buffer.open(QIODevice::WriteOnly);
+    toXml(input, &buffer);
+    return xml;
 }
 
 bool ParserManager::loadDictionary(QString key) {
-    return !(dictionaries->loadDictionary(key).isEmpty());
+    return dictionaries->loadDictionary(key) != NULL;
 }
 
+bool ParserManager::buildDictionarySnapshot(QString key) {
+    return dictionaries->buildSnapshot(key);
+}
 
+void ParserManager::setDictionarySnapshotsEnabled(bool enabled) {
+    dictionaries->setSnapshotsEnabled(enabled);
+}
+
+int ParserManager::reloadDictionaries() {
+    return dictionaries->reloadModified();
+}
+
+void ParserManager::releaseRetired() {
+    dictionaries->releaseRetired();
+    for (int i = 0; i < parserList.size(); ++i) {
+        parserList.at(i)->releaseRetired();
+    }
+}
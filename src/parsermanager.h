@@ -8,12 +8,26 @@
 
 #include <QString>
 #include <QList>
+#include <QVector>
 #include <QByteArray>
 #include <QDir>
 #include <QDomDocument>
+#include <QIODevice>
+#include <QThreadPool>
+
+#include <latencyhistogram.h>
+
+#define DEFAULT_STREAM_CHUNK 65536
+#define DEFAULT_STREAM_LIMIT 16777216
+#define PARALLEL_BATCH 64
 
 class DictionaryManager;
 class Parser;
+class ParseResult;
+class OutputSink;
+class InputReader;
+class ParseVisitor;
+class BatchResult;
 
 /**
 * ParserManager cumple la función de gestionar los analizadores de texto para
@@ -32,6 +46,74 @@ class ParserManager
         /** Lista de analizadores de texto. */
         QList<Parser *> parserList;
 
+        /** Cantidad de caracteres que se leen en cada bloque de un flujo. */
+        int streamChunk;
+
+        /**
+        * Cantidad máxima de caracteres pendientes que se conservan en memoria
+        * al analizar un flujo.
+        */
+        int streamLimit;
+
+        /** Cantidad de hilos con que se analizan las ocurrencias. */
+        int workerCount;
+
+        /** Hilos de trabajo del análisis en paralelo. */
+        QThreadPool workerPool;
+
+        /** Indica si toDom analiza todos los formatos a la vez. */
+        bool concurrentFormats;
+
+        /** Hilos en los que se analiza cada formato en toDom. */
+        QThreadPool formatPool;
+
+        /**
+        * Analiza una ocurrencia del formato del parser de índice parserPos y
+        * la entrega a sink.
+        * @param input texto que contiene la ocurrencia.
+        * @param pos posición de la ocurrencia en input.
+        * @param length longitud de la ocurrencia.
+        * @param offset posición de la ocurrencia en la entrada completa.
+        * @param byteOffset posición en bytes de la ocurrencia en la entrada
+        * UTF-8, o -1 si la entrada no se leyó como UTF-8.
+        * @param result resultado donde se construye el árbol.
+        * @param sink destino de la ocurrencia.
+        * @return Devuelve true si se obtuvo un árbol de sintaxis.
+        */
+        bool emitOccurrence(int parserPos, const QString &input, int pos,
+                            int length, qint64 offset, qint64 byteOffset,
+                            ParseResult &result, OutputSink *sink);
+
+        /**
+        * Analiza por bloques el texto entregado por reader igual que
+        * parseAll, entregando los resultados a sink a medida que se deciden.
+        * @param reader origen del texto.
+        * @param sink destino de los resultados.
+        * @return Devuelve la cantidad de ocurrencias encontradas.
+        */
+        int scan(InputReader &reader, OutputSink *sink);
+
+        /**
+        * Analiza en paralelo las ocurrencias del formato del parser de índice
+        * parserPos. Las ocurrencias se localizan por lotes, se analizan en los
+        * hilos de trabajo y se entregan a sink en el orden de la entrada.
+        * @param input apunta a la entrada de texto que se analizará.
+        * @param sink destino de los resultados.
+        * @param parserPos índice del parser.
+        * @return Devuelve la cantidad de ocurrencias encontradas.
+        */
+        int parseFormatParallel(QString *input, OutputSink *sink,
+                                int parserPos);
+
+        /**
+        * Analiza la entrada con el parser de índice parserPos sobre un
+        * documento DOM propio, de forma que puede ejecutarse en otro hilo.
+        * @param input apunta a la entrada de texto que se analizará.
+        * @param parserPos índice del parser.
+        * @return Devuelve el documento con las ocurrencias del formato.
+        */
+        QDomDocument formatDocument(QString *input, int parserPos);
+
     public:
 
         /**
@@ -66,6 +148,18 @@ class ParserManager
         */
         int parseFormat(QString *input, QDomDocument &doc, int parserPos);
 
+        /**
+        * Analiza la entrada de texto apuntada por input con el parser de
+        * índice parserPos y entrega cada ocurrencia a sink a medida que se
+        * reconoce.
+        * @param input apunta a la entrada de texto que se analizará.
+        * @param sink destino de los resultados.
+        * @param parserPos índice del parser con el cual se procesará la
+        * entrada.
+        * @return Devuelve la cantidad de ocurrencias encontradas.
+        */
+        int parseFormat(QString *input, OutputSink *sink, int parserPos);
+
         /**
         * Analiza la entrada de texto apuntada por input con el parser cuyo
         * formato es frmt.
@@ -78,8 +172,123 @@ class ParserManager
         */
         int parseFormat(QString *input, QDomDocument &doc, QString format);
 
+        /**
+        * Analiza cada registro de records como una ocurrencia completa del
+        * formato format, sin buscarla dentro del registro.
+        * @param format formato del parser con el cual se analizan los
+        * registros.
+        * @param records registros a analizar, deben existir mientras se use
+        * batch.
+        * @param batch lote donde se agregan los árboles de los registros.
+        * @return Devuelve la cantidad de registros reconocidos, o -1 si no
+        * existe un analizador para el formato.
+        * @see Parser::parse(const QStringList &, BatchResult &)
+        */
+        int parseRecords(QString format, const QStringList &records,
+                         BatchResult &batch);
+
+        /**
+        * Analiza los registros contenidos en buffer, que comienzan en las
+        * posiciones offsets, igual que la versión que recibe una lista.
+        * @see Parser::parse(const QString &, const QVector<int> &,
+        * BatchResult &)
+        */
+        int parseRecords(QString format, const QString &buffer,
+                         const QVector<int> &offsets, BatchResult &batch);
+
+        /**
+        * Analiza la entrada de texto apuntada por input con todos los
+        * analizadores a la vez, tomando en cada punto la ocurrencia más a la
+        * izquierda y más larga. El texto que no corresponde a ningún formato
+        * se devuelve en elementos "unknow".
+        * @param imput apunta a la entrada de texto que se analizará.
+        * @return Devuelve el documento DOM resultante.
+        */
         QDomDocument parseAll(QString *input);
 
+        /**
+        * Analiza la entrada de texto apuntada por input igual que
+        * parseAll(QString *) y entrega los resultados a sink.
+        * @param imput apunta a la entrada de texto que se analizará.
+        * @param sink destino de los resultados.
+        */
+        void parseAll(QString *input, OutputSink *sink);
+
+        /**
+        * Analiza el texto UTF-8 leído de device igual que parseAll, leyéndolo
+        * en bloques y entregando los resultados a sink a medida que se
+        * deciden, de forma que la entrada no tiene que caber en memoria. Las
+        * ocurrencias que cruzan el límite entre dos bloques se reconocen
+        * completas. Las posiciones se expresan en caracteres desde el inicio
+        * del flujo.
+        * @param device dispositivo abierto para lectura.
+        * @param sink destino de los resultados.
+        * @return Devuelve la cantidad de ocurrencias encontradas.
+        */
+        int parseStream(QIODevice *device, OutputSink *sink);
+
+        /**
+        * Analiza el fichero de texto UTF-8 de ruta path igual que
+        * parseStream, proyectándolo en memoria en lugar de leerlo. Los
+        * bloques ASCII se convierten sin decodificar UTF-8 y cada ocurrencia
+        * informa su posición en bytes dentro del fichero.
+        * @param path ruta del fichero.
+        * @param sink destino de los resultados.
+        * @return Devuelve la cantidad de ocurrencias encontradas o -1 si el
+        * fichero no se pudo abrir.
+        */
+        int parseFile(QString path, OutputSink *sink);
+
+        /**
+        * Establece los límites de memoria del análisis de flujos. Cuando el
+        * texto pendiente alcanza memoryLimit caracteres sin que se pueda
+        * decidir la siguiente ocurrencia, esta se decide con el texto
+        * disponible.
+        * @param chunkSize cantidad de caracteres de cada lectura.
+        * @param memoryLimit cantidad máxima de caracteres pendientes.
+        */
+        void setStreamLimits(int chunkSize, int memoryLimit);
+
+        /**
+        * Establece la cantidad de hilos con que parseFormat analiza las
+        * ocurrencias de un formato. Con un solo hilo el análisis es secuencial;
+        * con más, el resultado es idéntico al secuencial.
+        * @param count cantidad de hilos, si es menor que 1 se utiliza la
+        * cantidad de núcleos disponibles.
+        */
+        void setWorkerCount(int count);
+
+        /** Retorna la cantidad de hilos con que se analizan las ocurrencias. */
+        int getWorkerCount();
+
+        /**
+        * Establece si toDom analiza todos los formatos a la vez, cada uno en
+        * su propio hilo. Los resultados se agregan al documento en el orden de
+        * los formatos, por lo que el documento es el mismo que el secuencial.
+        * @param enabled indica si los formatos se analizan a la vez.
+        */
+        void setConcurrentFormats(bool enabled);
+
+        /**
+        * Establece en todos los analizadores las variables que interesan de
+        * los resultados. Los subárboles que no pueden contener ninguna de
+        * ellas se entregan reducidos a su nodo raíz.
+        * @param names nombres de las variables solicitadas, o una lista vacía
+        * para obtener los árboles completos.
+        * @see Parser::setProjection
+        */
+        void setProjection(const QStringList &names);
+
+        /**
+        * Retorna, para cada formato, la cantidad de ocurrencias analizadas, los
+        * bytes procesados y los percentiles del tiempo de análisis en
+        * nanosegundos. Se puede consultar mientras se analiza.
+        */
+        QList<FormatStats> formatStats();
+
+        /** Elimina los tiempos de análisis registrados de todos los formatos. */
+        void resetStats();
+
         /**
         * Analiza la entrada de texto apuntada por input con todos los
         * analizadores de texto disponibles en parserList. Retorna un documento
@@ -99,8 +308,81 @@ class ParserManager
         */
         QByteArray toXml(QString *input);
 
+        /**
+        * Analiza la entrada de texto apuntada por input con todos los
+        * analizadores de texto disponibles y escribe el xml resultante en
+        * device a medida que se reconoce cada ocurrencia, sin construir el
+        * documento DOM.
+        * @param imput apunta a la entrada de texto que se analizará.
+        * @param device dispositivo abierto para escritura.
+        */
+        void toXml(QString *input, QIODevice *device);
+
+        /**
+        * Analiza la entrada de texto apuntada por input con todos los
+        * analizadores de texto disponibles, en el mismo orden que toDom, y
+        * entrega cada ocurrencia a sink a medida que se reconoce.
+        * @param imput apunta a la entrada de texto que se analizará.
+        * @param sink destino de los resultados.
+        */
+        void toSink(QString *input, OutputSink *sink);
+
+        /**
+        * Analiza la entrada de texto apuntada por input igual que toSink y
+        * entrega a visitor los eventos de cada ocurrencia, sin convertir los
+        * árboles a otro formato.
+        * @param imput apunta a la entrada de texto que se analizará.
+        * @param visitor receptor de los eventos.
+        */
+        void toVisitor(QString *input, ParseVisitor *visitor);
+
+        /**
+        * Analiza la entrada de texto apuntada por input igual que toSink y
+        * escribe en device una línea JSON por ocurrencia.
+        * @see JsonSink
+        */
+        void toJson(QString *input, QIODevice *device);
+
+        /**
+        * Analiza la entrada de texto apuntada por input igual que toSink y
+        * escribe en device los árboles en formato binario compacto.
+        * @see BinarySink
+        */
+        void toBinary(QString *input, QIODevice *device);
+
         /** Carga el contenido del diccionario de nombre key. */
         bool loadDictionary(QString key);
+
+        /**
+        * Genera la imagen precompilada del diccionario de nombre key para que
+        * los procesos que lo utilicen la proyecten en memoria al cargarlo.
+        */
+        bool buildDictionarySnapshot(QString key);
+
+        /**
+        * Establece si al cargar los diccionarios se utilizan sus imágenes
+        * precompiladas. Por defecto está desactivado.
+        * @see DictionaryManager::setSnapshotsEnabled
+        */
+        void setDictionarySnapshotsEnabled(bool enabled);
+
+        /**
+        * Vuelve a cargar los diccionarios cuyos ficheros se modificaron. Los
+        * nuevos autómatas se utilizan en los análisis siguientes sin detener
+        * los que están en curso.
+        * @return Devuelve la cantidad de diccionarios recargados.
+        * @see releaseRetired
+        */
+        int reloadDictionaries();
+
+        /**
+        * Libera los autómatas y tablas de diccionarios sustituidos al cargar o
+        * recargar diccionarios, y las tablas de primeros caracteres
+        * sustituidas de cada parser. Un proceso de larga duración que recarga
+        * diccionarios debe invocarlo periódicamente en un momento en que no
+        * haya análisis en curso, ya que estos pueden seguir usándolos.
+        */
+        void releaseRetired();
 };
 
 #endif // PARSERCONTROLLER_H
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <parsevisitor.h>
+#include <astnode.h>
+
+ParseVisitor::~ParseVisitor() {
+}
+
+void ParseVisitor::beginOccurrence(const QString &format,
+                                   const SymbolTable *symbols, qint64 offset) {
+    Q_UNUSED(format);
+    Q_UNUSED(symbols);
+    Q_UNUSED(offset);
+}
+
+void ParseVisitor::enterRule(int tag, int name, qint64 position, int length) {
+    Q_UNUSED(tag);
+    Q_UNUSED(name);
+    Q_UNUSED(position);
+    Q_UNUSED(length);
+}
+
+void ParseVisitor::leaveRule(int tag, int name, qint64 position, int length) {
+    Q_UNUSED(tag);
+    Q_UNUSED(name);
+    Q_UNUSED(position);
+    Q_UNUSED(length);
+}
+
+void ParseVisitor::terminal(int tag, int name, qint64 position, int length,
+                            const QStringRef &text) {
+    Q_UNUSED(tag);
+    Q_UNUSED(name);
+    Q_UNUSED(position);
+    Q_UNUSED(length);
+    Q_UNUSED(text);
+}
+
+void ParseVisitor::endOccurrence() {
+}
+
+void ParseVisitor::walk(AstNode *node, qint64 base) {
+    QStringRef textRef = node->getReference();
+    int tag = node->getTagName();
+    int name = node->getName();
+    qint64 position = base + textRef.position();
+
+    if (node->childCount() == 0) {
+        terminal(tag, name, position, textRef.length(), textRef);
+        return;
+    }
+
+    enterRule(tag, name, position, textRef.length());
+    for (AstNode *child = node->getFirstChild(); child;
+         child = child->getNextSibling()) {
+        walk(child, base);
+    }
+    leaveRule(tag, name, position, textRef.length());
+}
@@ -0,0 +1,76 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef PARSEVISITOR_H
+#define PARSEVISITOR_H
+
+#include <QString>
+#include <QStringRef>
+
+class AstNode;
+class SymbolTable;
+
+/**
+* ParseVisitor recibe como eventos la estructura reconocida en cada
+* ocurrencia, sin que el consumidor tenga que recorrer ni conservar el árbol.
+* Solo se reciben los eventos del análisis aceptado: las alternativas
+* descartadas al retroceder nunca se notifican.
+*
+* Las etiquetas y nombres son identificadores de la tabla de símbolos de la
+* gramática, y las posiciones son relativas a la entrada completa.
+*/
+class ParseVisitor
+{
+    public:
+
+        /** Destructor. */
+        virtual ~ParseVisitor();
+
+        /**
+        * Se invoca al comenzar los eventos de una ocurrencia.
+        * @param format nombre del formato reconocido.
+        * @param symbols tabla de símbolos de la gramática.
+        * @param offset posición de la ocurrencia en la entrada completa.
+        */
+        virtual void beginOccurrence(const QString &format,
+                                     const SymbolTable *symbols,
+                                     qint64 offset);
+
+        /**
+        * Se invoca al entrar en un elemento que tiene elementos hijos.
+        * @param tag identificador de la etiqueta del elemento.
+        * @param name identificador del nombre del elemento.
+        * @param position posición del texto del elemento.
+        * @param length longitud del texto del elemento.
+        */
+        virtual void enterRule(int tag, int name, qint64 position, int length);
+
+        /** Se invoca al salir de un elemento que tiene elementos hijos. */
+        virtual void leaveRule(int tag, int name, qint64 position, int length);
+
+        /**
+        * Se invoca por cada elemento sin hijos.
+        * @param tag identificador de la etiqueta del elemento.
+        * @param name identificador del nombre del elemento.
+        * @param position posición del texto del elemento.
+        * @param length longitud del texto del elemento.
+        * @param text texto del elemento, válido solo durante la llamada.
+        */
+        virtual void terminal(int tag, int name, qint64 position, int length,
+                              const QStringRef &text);
+
+        /** Se invoca al terminar los eventos de una ocurrencia. */
+        virtual void endOccurrence();
+
+        /**
+        * Genera los eventos del árbol cuya raíz es node.
+        * @param node raíz del árbol.
+        * @param base valor que se suma a la posición de cada nodo para
+        * obtener su posición en la entrada completa.
+        */
+        void walk(AstNode *node, qint64 base = 0);
+};
+
+#endif // PARSEVISITOR_H
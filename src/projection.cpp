@@ -0,0 +1,42 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <projection.h>
+#include <astnode.h>
+
+Projection::Projection() {
+}
+
+Projection::Projection(const QVector<bool> &requested,
+                       const QVector<bool> &keepChildren) {
+    this->requested = requested;
+    this->keepChildren = keepChildren;
+}
+
+bool Projection::isActive() const {
+    return !keepChildren.isEmpty();
+}
+
+bool Projection::keeps(int rule) const {
+    return keepChildren.isEmpty() || keepChildren.at(rule);
+}
+
+bool Projection::isRequested(int name) const {
+    return name >= 0 && name < requested.size() && requested.at(name);
+}
+
+void Projection::collect(AstNode *tree, QVector<ProjectedField> &fields) const {
+    if (isRequested(tree->getName())) {
+        ProjectedField field;
+        field.name = tree->getName();
+        field.position = tree->getReference().position();
+        field.length = tree->getReference().length();
+        fields.append(field);
+    }
+    for (AstNode *child = tree->getFirstChild(); child;
+         child = child->getNextSibling()) {
+        collect(child, fields);
+    }
+}
@@ -0,0 +1,76 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef PROJECTION_H
+#define PROJECTION_H
+
+#include <QVector>
+
+class AstNode;
+
+/**
+* Variable solicitada encontrada en una ocurrencia.
+*/
+struct ProjectedField
+{
+    /** Identificador del nombre de la variable. */
+    int name;
+
+    /** Posición del texto de la variable en la ocurrencia. */
+    int position;
+
+    /** Longitud del texto de la variable. */
+    int length;
+};
+
+/**
+* Projection describe las variables de una gramática que interesan al
+* consumidor. Para cada regla indica si su subárbol puede contener alguna de
+* ellas; los subárboles que no pueden contenerlas se reducen a su nodo raíz
+* durante el análisis.
+*/
+class Projection
+{
+    private:
+
+        /** Indica, por identificador de símbolo, si el nombre se solicitó. */
+        QVector<bool> requested;
+
+        /**
+        * Indica, por regla, si los descendientes de su nodo pueden tener un
+        * nombre solicitado.
+        */
+        QVector<bool> keepChildren;
+
+    public:
+
+        /** Constructor por defecto, crea una proyección inactiva. */
+        Projection();
+
+        /**
+        * Constructor.
+        * @param requested nombres solicitados por identificador de símbolo.
+        * @param keepChildren reglas cuyos descendientes se conservan.
+        */
+        Projection(const QVector<bool> &requested,
+                   const QVector<bool> &keepChildren);
+
+        /** Retorna si la proyección está activa. */
+        bool isActive() const;
+
+        /** Retorna si se conservan los descendientes de la regla rule. */
+        bool keeps(int rule) const;
+
+        /** Retorna si el nombre de identificador name fue solicitado. */
+        bool isRequested(int name) const;
+
+        /**
+        * Agrega a fields, en preorden, los nodos del árbol tree cuyo nombre
+        * fue solicitado.
+        */
+        void collect(AstNode *tree, QVector<ProjectedField> &fields) const;
+};
+
+#endif // PROJECTION_H
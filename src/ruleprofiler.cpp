@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <algorithm>
+
+#include <ruleprofiler.h>
+
+/** Ordena los contadores de mayor a menor tiempo acumulado. */
+static bool slowerThan(const RuleStats &a, const RuleStats &b) {
+    return a.nsecs > b.nsecs;
+}
+
+RuleProfiler::RuleProfiler() {
+    this->size = 0;
+}
+
+void RuleProfiler::reset(int ruleCount) {
+    counters.reset(ruleCount > 0 ? new Counters[ruleCount] : NULL);
+    size = ruleCount;
+    for (int i = 0; i < size; ++i) {
+        counters[i].attempts.store(0);
+        counters[i].successes.store(0);
+        counters[i].consumed.store(0);
+        counters[i].nsecs.store(0);
+    }
+}
+
+void RuleProfiler::add(const QVector<RuleCounters> &local) {
+    int count = qMin(size, local.size());
+    for (int i = 0; i < count; ++i) {
+        const RuleCounters &l = local.at(i);
+        if (l.attempts == 0) {
+            continue;
+        }
+        Counters &c = counters[i];
+        c.attempts.fetchAndAddRelaxed(l.attempts);
+        c.successes.fetchAndAddRelaxed(l.successes);
+        c.consumed.fetchAndAddRelaxed(l.consumed);
+        c.nsecs.fetchAndAddRelaxed(l.nsecs);
+    }
+}
+
+QVector<RuleStats> RuleProfiler::stats() const {
+    QVector<RuleStats> result;
+    for (int i = 0; i < size; ++i) {
+        const Counters &c = counters[i];
+        RuleStats entry;
+        entry.rule = i;
+        entry.attempts = c.attempts.load();
+        if (entry.attempts == 0) {
+            continue;
+        }
+        entry.successes = c.successes.load();
+        entry.failures = entry.attempts - entry.successes;
+        entry.consumed = c.consumed.load();
+        entry.nsecs = c.nsecs.load();
+        result.append(entry);
+    }
+
+    std::sort(result.begin(), result.end(), slowerThan);
+    return result;
+}
@@ -0,0 +1,109 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef RULEPROFILER_H
+#define RULEPROFILER_H
+
+#include <QAtomicInteger>
+#include <QScopedArrayPointer>
+#include <QVector>
+
+/**
+* Contadores acumulados de una regla de la gramática.
+*/
+struct RuleStats
+{
+    /** Índice de la regla. */
+    int rule;
+
+    /** Cantidad de veces que se evaluó la regla. */
+    qint64 attempts;
+
+    /** Cantidad de evaluaciones que reconocieron texto. */
+    qint64 successes;
+
+    /** Cantidad de evaluaciones que no reconocieron texto. */
+    qint64 failures;
+
+    /** Cantidad de caracteres consumidos por las evaluaciones exitosas. */
+    qint64 consumed;
+
+    /** Tiempo acumulado en nanosegundos, incluyendo el de las subreglas. */
+    qint64 nsecs;
+};
+
+/**
+* Contadores de una regla durante un análisis, sin sincronizar.
+*/
+struct RuleCounters
+{
+    /** Cantidad de veces que se evaluó la regla. */
+    qint64 attempts;
+
+    /** Cantidad de evaluaciones que reconocieron texto. */
+    qint64 successes;
+
+    /** Cantidad de caracteres consumidos por las evaluaciones exitosas. */
+    qint64 consumed;
+
+    /** Tiempo acumulado en nanosegundos, incluyendo el de las subreglas. */
+    qint64 nsecs;
+};
+
+/**
+* RuleProfiler acumula por regla la cantidad de evaluaciones, su resultado, el
+* texto consumido y el tiempo empleado. Cada análisis registra en los
+* contadores de su ParseContext, que no se comparten entre hilos, y los suma a
+* los del perfil una sola vez al terminar; los contadores del perfil son
+* atómicos, por lo que varios hilos pueden sumar a la vez.
+*
+* Los contadores solo se registran si la biblioteca se compila con la macro
+* GENERIC_PARSER_PROFILING; de lo contrario el análisis no tiene ningún costo
+* adicional y los contadores permanecen en cero.
+*/
+class RuleProfiler
+{
+    private:
+
+        /** Contadores atómicos de una regla. */
+        struct Counters
+        {
+            QAtomicInteger<qint64> attempts;
+            QAtomicInteger<qint64> successes;
+            QAtomicInteger<qint64> consumed;
+            QAtomicInteger<qint64> nsecs;
+        };
+
+        /** Contadores de cada regla. */
+        QScopedArrayPointer<Counters> counters;
+
+        /** Cantidad de reglas. */
+        int size;
+
+    public:
+
+        /** Constructor, crea un perfil sin reglas. */
+        RuleProfiler();
+
+        /**
+        * Reinicia los contadores para una gramática de ruleCount reglas. No se
+        * debe invocar mientras se analiza.
+        */
+        void reset(int ruleCount);
+
+        /**
+        * Suma los contadores de un análisis, indexados por regla.
+        * @param local contadores registrados durante el análisis.
+        */
+        void add(const QVector<RuleCounters> &local);
+
+        /**
+        * Retorna los contadores de las reglas evaluadas alguna vez, ordenados
+        * de mayor a menor tiempo acumulado.
+        */
+        QVector<RuleStats> stats() const;
+};
+
+#endif // RULEPROFILER_H
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <streamreader.h>
+
+StreamReader::StreamReader(QIODevice *device) : stream(device) {
+    stream.setCodec("UTF-8");
+
+    /* QTextStream omite la marca de orden de bytes, por lo que se comprueba
+    si existe sin consumirla.*/
+    this->bomLength = device->peek(3) == QByteArray("\xEF\xBB\xBF") ? 3 : 0;
+}
+
+QString StreamReader::read(int maxChars) {
+
+    /* El decodificador de QTextStream conserva los caracteres UTF-8 divididos
+    entre dos lecturas.*/
+    return stream.read(maxChars);
+}
+
+bool StreamReader::atEnd() const {
+    return stream.atEnd();
+}
+
+qint64 StreamReader::startByte() const {
+    return bomLength;
+}
@@ -0,0 +1,45 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef STREAMREADER_H
+#define STREAMREADER_H
+
+#include <QIODevice>
+#include <QTextStream>
+
+#include <inputreader.h>
+
+/**
+* StreamReader lee texto UTF-8 de un dispositivo de entrada.
+*/
+class StreamReader : public InputReader
+{
+    private:
+
+        /** Flujo que decodifica el contenido del dispositivo. */
+        QTextStream stream;
+
+        /** Longitud en bytes de la marca de orden de bytes omitida. */
+        qint64 bomLength;
+
+    public:
+
+        /**
+        * Constructor.
+        * @param device dispositivo abierto para lectura.
+        */
+        StreamReader(QIODevice *device);
+
+        /** Lee el siguiente bloque de texto del dispositivo. */
+        QString read(int maxChars);
+
+        /** Retorna si se ha leído todo el dispositivo. */
+        bool atEnd() const;
+
+        /** Retorna la longitud de la marca de orden de bytes omitida. */
+        qint64 startByte() const;
+};
+
+#endif // STREAMREADER_H
@@ -0,0 +1,37 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <symboltable.h>
+
+void SymbolTable::clear() {
+    names.clear();
+    ids.clear();
+}
+
+int SymbolTable::intern(const QString &name) {
+    QHash<QString, int>::const_iterator it = ids.constFind(name);
+    if (it != ids.constEnd()) {
+        return it.value();
+    }
+    int id = names.size();
+    names.append(name);
+    ids.insert(name, id);
+    return id;
+}
+
+int SymbolTable::id(const QString &name) const {
+    return ids.value(name, -1);
+}
+
+QString SymbolTable::name(int id) const {
+    if (id < 0 || id >= names.size()) {
+        return QString();
+    }
+    return names.at(id);
+}
+
+int SymbolTable::size() const {
+    return names.size();
+}
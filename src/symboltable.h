@@ -0,0 +1,56 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+/**
+* SymbolTable asigna un identificador entero a cada etiqueta y nombre de
+* variable de una gramática. Los nodos del árbol guardan solo estos
+* identificadores, por lo que comparar nombres se reduce a comparar enteros.
+*/
+class SymbolTable
+{
+    private:
+
+        /** Nombres ordenados por identificador. */
+        QVector<QString> names;
+
+        /** Identificador de cada nombre. */
+        QHash<QString, int> ids;
+
+    public:
+
+        /** Elimina todos los símbolos. */
+        void clear();
+
+        /**
+        * Retorna el identificador de name, agregándolo a la tabla si no
+        * existe.
+        * @param name nombre a registrar.
+        */
+        int intern(const QString &name);
+
+        /**
+        * Retorna el identificador de name o -1 si no está registrado.
+        * @param name nombre buscado.
+        */
+        int id(const QString &name) const;
+
+        /**
+        * Retorna el nombre del identificador id o una cadena vacía si no
+        * existe.
+        */
+        QString name(int id) const;
+
+        /** Retorna la cantidad de símbolos registrados. */
+        int size() const;
+};
+
+#endif // SYMBOLTABLE_H
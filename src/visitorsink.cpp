@@ -0,0 +1,17 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <visitorsink.h>
+#include <parsevisitor.h>
+
+VisitorSink::VisitorSink(ParseVisitor *visitor) {
+    this->visitor = visitor;
+}
+
+void VisitorSink::occurrence(const Occurrence &ocur) {
+    visitor->beginOccurrence(ocur.format, ocur.symbols, ocur.offset);
+    visitor->walk(ocur.tree, ocur.base());
+    visitor->endOccurrence();
+}
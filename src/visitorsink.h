@@ -0,0 +1,37 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef VISITORSINK_H
+#define VISITORSINK_H
+
+#include <outputsink.h>
+
+class ParseVisitor;
+
+/**
+* VisitorSink entrega cada ocurrencia reconocida como eventos a un
+* ParseVisitor. El árbol se recorre mientras aún está en la arena del
+* análisis, que se reutiliza en la ocurrencia siguiente.
+*/
+class VisitorSink : public OutputSink
+{
+    private:
+
+        /** Receptor de los eventos. */
+        ParseVisitor *visitor;
+
+    public:
+
+        /**
+        * Constructor.
+        * @param visitor receptor de los eventos.
+        */
+        VisitorSink(ParseVisitor *visitor);
+
+        /** Genera los eventos de la ocurrencia ocur. */
+        void occurrence(const Occurrence &ocur);
+};
+
+#endif // VISITORSINK_H
@@ -0,0 +1,65 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <xmlstreamsink.h>
+#include <domsink.h>
+#include <astnode.h>
+#include <symboltable.h>
+
+XmlStreamSink::XmlStreamSink(QIODevice *device) : writer(device) {
+
+    /* Se utiliza la misma sangría que QDomDocument::toByteArray.*/
+    writer.setAutoFormatting(true);
+    writer.setAutoFormattingIndent(1);
+}
+
+void XmlStreamSink::begin() {
+    writer.writeStartElement(ROOT_TAG);
+}
+
+void XmlStreamSink::occurrence(const Occurrence &ocur) {
+    writer.writeStartElement(ocur.format);
+    writer.writeTextElement(INPUT_TAG, ocur.input.toString());
+    writeNode(ocur.tree, ocur.symbols, ocur.base(), ocur.nsecs);
+    writer.writeEndElement();
+}
+
+void XmlStreamSink::unknown(const QStringRef &text, qint64 offset) {
+    Q_UNUSED(offset);
+    writer.writeTextElement(UNKNOWN_TAG, text.toString());
+}
+
+void XmlStreamSink::end() {
+    writer.writeEndElement();
+}
+
+void XmlStreamSink::writeNode(AstNode *node, const SymbolTable *symbols,
+                              qint64 base, qint64 nsecs) {
+    QStringRef textRef = node->getReference();
+
+    /* Se escriben los atributos de posición y longitud del texto
+    referenciado, y el nombre si es diferente al de la etiqueta.*/
+    writer.writeStartElement(symbols->name(node->getTagName()));
+    writer.writeAttribute(ATTR_POS, QString::number(base + textRef.position()));
+    writer.writeAttribute(ATTR_LENGTH, QString::number(textRef.length()));
+    if (node->getName() != node->getTagName()) {
+        writer.writeAttribute(ATTR_NAME, symbols->name(node->getName()));
+    }
+    if (nsecs >= 0) {
+        writer.writeAttribute(ATTR_MSECS, milliseconds(nsecs));
+    }
+
+    /* Si el nodo no tiene elementos hijos se escribe el texto referenciado,
+    de lo contrario se escribe cada uno de los hijos.*/
+    if (node->childCount() == 0) {
+        writer.writeCharacters(textRef.toString());
+    } else {
+        for (AstNode *child = node->getFirstChild(); child;
+             child = child->getNextSibling()) {
+            writeNode(child, symbols, base, -1);
+        }
+    }
+    writer.writeEndElement();
+}
@@ -0,0 +1,58 @@
+/**
+* @file
+* @author Isbel Ochoa Izquierdo
+*/
+
+#ifndef XMLSTREAMSINK_H
+#define XMLSTREAMSINK_H
+
+#include <QIODevice>
+#include <QXmlStreamWriter>
+
+#include <outputsink.h>
+
+/**
+* XmlStreamSink escribe los resultados del análisis directamente en un
+* dispositivo a medida que se reconocen, con la misma estructura xml que
+* DomSink pero sin construir el documento en memoria.
+*/
+class XmlStreamSink : public OutputSink
+{
+    private:
+
+        /** Escritor del xml resultante. */
+        QXmlStreamWriter writer;
+
+        /**
+        * Escribe el elemento del nodo node y sus hijos.
+        * @param node nodo a escribir.
+        * @param symbols tabla de símbolos de la gramática.
+        * @param base valor que se suma a la posición de cada nodo.
+        * @param nsecs tiempo de análisis en nanosegundos que se escribe en el
+        * nodo raíz, o -1 en los demás nodos.
+        */
+        void writeNode(AstNode *node, const SymbolTable *symbols, qint64 base,
+                       qint64 nsecs);
+
+    public:
+
+        /**
+        * Constructor.
+        * @param device dispositivo abierto para escritura.
+        */
+        XmlStreamSink(QIODevice *device);
+
+        /** Escribe el inicio del elemento raíz. */
+        void begin();
+
+        /** Escribe el elemento de la ocurrencia ocur. */
+        void occurrence(const Occurrence &ocur);
+
+        /** Escribe un elemento con el texto no reconocido. */
+        void unknown(const QStringRef &text, qint64 offset);
+
+        /** Escribe el final del elemento raíz. */
+        void end();
+};
+
+#endif // XMLSTREAMSINK_H
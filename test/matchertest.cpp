@@ -0,0 +1,480 @@
+/**
+ * @file
+ * @author Isbel Ochoa Izquierdo
+ */
+
+#include <QString>
+#include <QStringList>
+#include <QRegularExpression>
+#include <QTemporaryDir>
+#include <QFile>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+#include <matcher.h>
+#include <charset.h>
+#include <formatscanner.h>
+#include <dictionarymatcher.h>
+
+/**
+* Comprueba el análisis que Matcher hace de sus expresiones regulares: el texto
+* literal con que se filtran las búsquedas y los primeros caracteres con que
+* se descartan las reglas. Cada resultado se compara con una búsqueda sin
+* filtros de QRegularExpression sobre los mismos textos. También comprueba el
+* autómata con que DictionaryMatcher sustituye a las expresiones de los
+* diccionarios, y que se rechacen sus imágenes dañadas.
+*/
+
+/** Cantidad de comprobaciones fallidas. */
+static int failures = 0;
+
+/** Reporta una comprobación fallida. */
+static void fail(const char *check, const QString &pattern, bool minimal,
+                 const QString &subject, int from, const QString &detail) {
+    failures++;
+    std::printf("FAIL %s: /%s/%s en \"%s\" desde %d: %s\n", check,
+                pattern.toUtf8().constData(), minimal ? " (mínimo)" : "",
+                subject.toUtf8().constData(), from,
+                detail.toUtf8().constData());
+}
+
+/**
+* Compila pattern con las mismas opciones que Matcher. Las expresiones de
+* prueba no utilizan '$', por lo que no requieren traducción.
+*/
+static QRegularExpression reference(const QString &pattern, bool minimal) {
+    QRegularExpression::PatternOptions options =
+            QRegularExpression::DotMatchesEverythingOption |
+            QRegularExpression::UseUnicodePropertiesOption;
+    if (minimal) {
+        options |= QRegularExpression::InvertedGreedinessOption;
+    }
+    return QRegularExpression(pattern, options);
+}
+
+/**
+* Comprueba que las búsquedas de Matcher, que saltan a las posiciones donde
+* aparece su texto literal, encuentren las mismas coincidencias que la
+* búsqueda sin filtros, en el texto completo y en cada sección del mismo.
+*/
+static void checkSearch(const QString &pattern, bool minimal,
+                        const QStringList &subjects) {
+    Matcher matcher(pattern, minimal);
+    QRegularExpression regexp = reference(pattern, minimal);
+    QString literal = matcher.requiredLiteral();
+
+    for (int s = 0; s < subjects.size(); ++s) {
+        const QString &subject = subjects.at(s);
+        for (int from = 0; from <= subject.length(); ++from) {
+            QRegularExpressionMatch expected = regexp.match(subject, from);
+            int n = 0;
+            int pos = matcher.indexIn(subject, from, &n);
+            int expectedPos = expected.hasMatch() ? expected.capturedStart() : -1;
+            if (pos != expectedPos ||
+                    (pos != -1 && n != expected.capturedLength())) {
+                fail("indexIn", pattern, minimal, subject, from,
+                     QString("%1+%2, se esperaba %3+%4").arg(pos).arg(n)
+                     .arg(expectedPos).arg(expected.capturedLength()));
+            }
+
+            /* Toda coincidencia debe contener el texto literal obligatorio.*/
+            if (expected.hasMatch() && !literal.isEmpty() &&
+                    !expected.captured().contains(literal)) {
+                fail("requiredLiteral", pattern, minimal, subject, from,
+                     QString("\"%1\" no aparece en \"%2\"").arg(literal)
+                     .arg(expected.captured()));
+            }
+        }
+
+        /* Una sección se analiza como si fuera la entrada completa, por lo
+        que se compara con la búsqueda sobre una copia de la misma.*/
+        for (int begin = 0; begin <= subject.length(); ++begin) {
+            for (int end = begin; end <= subject.length(); ++end) {
+                QStringRef slice(&subject, begin, end - begin);
+                QString copy = slice.toString();
+                for (int from = 0; from <= copy.length(); ++from) {
+                    QRegularExpressionMatch expected = regexp.match(copy, from);
+                    int n = 0;
+                    int pos = matcher.indexIn(slice, from, &n);
+                    int expectedPos = expected.hasMatch() ?
+                                expected.capturedStart() : -1;
+                    if (pos != expectedPos ||
+                            (pos != -1 && n != expected.capturedLength())) {
+                        fail("indexIn(QStringRef)", pattern, minimal, copy,
+                             from, QString("%1+%2, se esperaba %3+%4").arg(pos)
+                             .arg(n).arg(expectedPos)
+                             .arg(expected.capturedLength()));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+* Comprueba que los primeros caracteres calculados por Matcher contengan el
+* primer carácter de toda coincidencia no vacía, de forma que una regla nunca
+* se descarte en una sección donde la búsqueda sin filtros la reconoce.
+*/
+static void checkFirst(const QString &pattern, bool minimal,
+                       const QStringList &subjects) {
+    Matcher matcher(pattern, minimal);
+    CharSet first;
+
+    /* Si la expresión no se puede analizar la regla nunca se descarta.*/
+    if (!matcher.firstChars(&first)) {
+        return;
+    }
+
+    QRegularExpression regexp = reference(pattern, minimal);
+    for (int s = 0; s < subjects.size(); ++s) {
+        const QString &subject = subjects.at(s);
+        for (int begin = 0; begin <= subject.length(); ++begin) {
+            for (int end = begin; end <= subject.length(); ++end) {
+                QStringRef slice(&subject, begin, end - begin);
+                QString copy = slice.toString();
+                for (int from = 0; from < copy.length(); ++from) {
+                    QRegularExpressionMatch match = regexp.match(copy, from);
+                    if (!match.hasMatch() || match.capturedLength() == 0) {
+                        continue;
+                    }
+                    ushort c = copy.at(match.capturedStart()).unicode();
+                    if (!first.contains(c)) {
+                        fail("firstChars", pattern, minimal, copy, from,
+                             QString("falta '%1' (U+%2)").arg(QChar(c))
+                             .arg(c, 4, 16, QChar('0')));
+                    }
+                    int index = first.indexIn(slice);
+                    if (index == -1 || index > match.capturedStart()) {
+                        fail("indexIn(CharSet)", pattern, minimal, copy, from,
+                             QString("%1, la coincidencia comienza en %2")
+                             .arg(index).arg(match.capturedStart()));
+                    }
+                    if (!first.occursIn(slice)) {
+                        fail("occursIn", pattern, minimal, copy, from,
+                             QString("se descarta la coincidencia \"%1\"")
+                             .arg(match.captured()));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+* Comprueba que FormatScanner termine y reporte las mismas ocurrencias no
+* vacías que la búsqueda sin filtros con la expresión equivalente expected,
+* aun cuando el formato reconoce texto vacío.
+*/
+static void checkScanner(const QString &pattern, const QString &expected,
+                         const QStringList &subjects) {
+    QRegularExpression regexp = reference(expected, true);
+    for (int s = 0; s < subjects.size(); ++s) {
+        const QString &subject = subjects.at(s);
+        FormatScanner scanner;
+        scanner.addFormat(Matcher(pattern));
+
+        int from = 0;
+        int steps = 0;
+        while (true) {
+            if (++steps > subject.length() + 2) {
+                fail("FormatScanner", pattern, true, subject, from,
+                     "la búsqueda no avanza");
+                break;
+            }
+
+            /* La ocurrencia esperada es la primera coincidencia no vacía a
+            partir de from.*/
+            int expectedPos = -1;
+            int expectedLength = 0;
+            for (int k = from; k <= subject.length(); ++k) {
+                QRegularExpressionMatch match = regexp.match(subject, k);
+                if (!match.hasMatch()) {
+                    break;
+                }
+                if (match.capturedLength() > 0) {
+                    expectedPos = match.capturedStart();
+                    expectedLength = match.capturedLength();
+                    break;
+                }
+                k = match.capturedStart();
+            }
+
+            int format = -1;
+            int length = 0;
+            int pos = scanner.next(subject, from, &format, &length);
+            if (pos != expectedPos ||
+                    (pos != -1 && length != expectedLength)) {
+                fail("FormatScanner", pattern, true, subject, from,
+                     QString("%1+%2, se esperaba %3+%4").arg(pos).arg(length)
+                     .arg(expectedPos).arg(expectedLength));
+                break;
+            }
+            if (pos == -1) {
+                break;
+            }
+            from = pos + length;
+        }
+    }
+}
+
+/**
+* Compila la expresión "\b(?:w1|w2|...)\b" equivalente al diccionario words.
+* Las palabras se ordenan de mayor a menor longitud para que, entre las
+* coincidencias que comienzan en la misma posición, se obtenga la más larga.
+*/
+static QRegularExpression dictionaryReference(QStringList words) {
+    for (int i = 1; i < words.size(); ++i) {
+        for (int j = i; j > 0 &&
+             words.at(j).length() > words.at(j - 1).length(); --j) {
+            words.swap(j, j - 1);
+        }
+    }
+    QStringList escaped;
+    for (int i = 0; i < words.size(); ++i) {
+        escaped << QRegularExpression::escape(words.at(i));
+    }
+    return QRegularExpression("\\b(?:" + escaped.join('|') + ")\\b",
+                              QRegularExpression::UseUnicodePropertiesOption);
+}
+
+/**
+* Comprueba que matcher encuentre en cada sección de subjects la misma
+* coincidencia que la expresión regexp sobre una copia de la sección.
+*/
+static void compareDictionary(const char *check, const DictionaryMatcher &matcher,
+                              const QRegularExpression &regexp,
+                              const QStringList &subjects) {
+    for (int s = 0; s < subjects.size(); ++s) {
+        const QString &subject = subjects.at(s);
+        for (int begin = 0; begin <= subject.length(); ++begin) {
+            for (int end = begin; end <= subject.length(); ++end) {
+                QStringRef slice(&subject, begin, end - begin);
+                QString copy = slice.toString();
+                QRegularExpressionMatch expected = regexp.match(copy);
+                int expectedPos = expected.hasMatch() ?
+                            expected.capturedStart() : -1;
+                int n = 0;
+                int pos = matcher.indexIn(slice, &n);
+                if (pos != expectedPos ||
+                        (pos != -1 && n != expected.capturedLength())) {
+                    fail(check, regexp.pattern(), false, copy, 0,
+                         QString("%1+%2, se esperaba %3+%4").arg(pos).arg(n)
+                         .arg(expectedPos).arg(expected.capturedLength()));
+                }
+            }
+        }
+    }
+}
+
+/**
+* Comprueba que el autómata de Aho-Corasick construido con words reconozca las
+* mismas palabras que la expresión regular a la que sustituye, tanto en memoria
+* como tras guardar su imagen y proyectarla desde el fichero.
+*/
+static void checkDictionary(const QStringList &words,
+                            const QStringList &subjects) {
+    DictionarySource source = { 0, 0, 0 };
+    DictionaryMatcher matcher;
+    matcher.build(words, source);
+    QRegularExpression regexp = dictionaryReference(words);
+    compareDictionary("DictionaryMatcher", matcher, regexp, subjects);
+
+    QTemporaryDir dir;
+    QString path = dir.path() + "/words.dic.bin";
+    DictionaryMatcher mapped;
+    if (!dir.isValid() || !matcher.save(path) || !mapped.map(path)) {
+        fail("DictionaryMatcher::map", regexp.pattern(), false, path, 0,
+             "no se pudo proyectar la imagen guardada");
+        return;
+    }
+    if (!mapped.isMapped() || mapped.size() != matcher.size()) {
+        fail("DictionaryMatcher::map", regexp.pattern(), false, path, 0,
+             QString("%1 palabras, se esperaban %2").arg(mapped.size())
+             .arg(matcher.size()));
+    }
+    compareDictionary("DictionaryMatcher::map", mapped, regexp, subjects);
+}
+
+/**
+* Disposición de la cabecera de la imagen de DictionaryMatcher, que permite
+* localizar los arreglos de estados y transiciones del fichero.
+*/
+struct SnapshotHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 byteOrder;
+    DictionarySource source;
+    qint32 nodeCount;
+    qint32 edgeCount;
+    qint32 maxLength;
+    qint32 wordCount;
+    qint64 nodesOffset;
+    qint64 edgesOffset;
+};
+
+/** Cantidad de campos enteros de cada estado de la imagen. */
+static const int NODE_FIELDS = 5;
+
+/** Tamaño en bytes de cada transición de la imagen. */
+static const int EDGE_SIZE = 8;
+
+/**
+* Escribe data en path y comprueba que DictionaryMatcher rechace la imagen.
+*/
+static void checkRejected(const QString &path, const QByteArray &data,
+                          const QString &detail) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            file.write(data) != data.size()) {
+        fail("DictionaryMatcher::map", path, false, "", 0,
+             "no se pudo escribir la imagen");
+        return;
+    }
+    file.close();
+
+    DictionaryMatcher matcher;
+    if (matcher.map(path)) {
+        fail("DictionaryMatcher::map", path, false, "", 0,
+             QString("se acepta la imagen %1").arg(detail));
+    }
+}
+
+/** Copia de image con el entero de 32 bits en offset sustituido por value. */
+static QByteArray patched(const QByteArray &image, qint64 offset, qint32 value) {
+    QByteArray copy = image;
+    memcpy(copy.data() + offset, &value, sizeof(value));
+    return copy;
+}
+
+/**
+* Comprueba que las imágenes truncadas o con índices fuera de rango se
+* rechacen al proyectarlas, en lugar de recorrer memoria fuera del fichero.
+*/
+static void checkCorrupted(const QStringList &words) {
+    DictionarySource source = { 0, 0, 0 };
+    DictionaryMatcher matcher;
+    matcher.build(words, source);
+
+    QTemporaryDir dir;
+    QString path = dir.path() + "/words.dic.bin";
+    QFile file(path);
+    if (!dir.isValid() || !matcher.save(path) ||
+            !file.open(QIODevice::ReadOnly)) {
+        fail("DictionaryMatcher::save", words.join('|'), false, path, 0,
+             "no se pudo guardar la imagen");
+        return;
+    }
+    QByteArray image = file.readAll();
+    file.close();
+    SnapshotHeader head;
+    memcpy(&head, image.constData(), sizeof(head));
+
+    /* Cualquier imagen truncada deja fuera parte de los arreglos.*/
+    for (int size = 0; size < image.size(); ++size) {
+        checkRejected(path, image.left(size),
+                      QString("truncada a %1 bytes").arg(size));
+    }
+
+    /* Cabeceras de otro formato o con arreglos fuera de la imagen.*/
+    QByteArray copy = image;
+    copy[0] = 'X';
+    checkRejected(path, copy, "con otra marca");
+    checkRejected(path, patched(image, offsetof(SnapshotHeader, version), 0),
+                  "de otra versión");
+    checkRejected(path, patched(image, offsetof(SnapshotHeader, nodeCount),
+                                head.nodeCount + 1000), "con más estados");
+    checkRejected(path, patched(image, offsetof(SnapshotHeader, edgeCount),
+                                head.edgeCount + 1000),
+                  "con más transiciones");
+    checkRejected(path, patched(image, offsetof(SnapshotHeader, maxLength), -1),
+                  "con longitud negativa");
+
+    /* Cada índice de un estado o destino de una transición, fuera de rango
+    por debajo o por encima, debe rechazarse.*/
+    QList<qint32> values;
+    values << -2 << head.nodeCount + head.edgeCount + 1;
+    for (int v = 0; v < values.size(); ++v) {
+        for (int u = 0; u < head.nodeCount; ++u) {
+            for (int field = 0; field < NODE_FIELDS; ++field) {
+                qint64 offset = head.nodesOffset +
+                        (u * NODE_FIELDS + field) * qint64(sizeof(qint32));
+                checkRejected(path, patched(image, offset, values.at(v)),
+                              QString("con el campo %1 del estado %2 en %3")
+                              .arg(field).arg(u).arg(values.at(v)));
+            }
+        }
+        for (int e = 0; e < head.edgeCount; ++e) {
+            qint64 offset = head.edgesOffset + e * qint64(EDGE_SIZE) + 4;
+            checkRejected(path, patched(image, offset, values.at(v)),
+                          QString("con el destino %1 de la transición %2")
+                          .arg(values.at(v)).arg(e));
+        }
+    }
+}
+
+int main() {
+    QStringList subjects;
+    subjects << "" << "abc" << "xabc" << "yabc" << "ab" << "ac" << "abbc"
+             << "aabcc" << "b" << "cd e" << "xyz" << "xxy" << "abd"
+             << "]-ax" << "a]b" << "\\5x" << "12 ab" << "A\nb" << "BCc"
+             << QString::fromUtf8("éab") << QString(QChar(0x4E2D)) + "a";
+
+    /* Alternativas en el primer nivel.*/
+    QStringList patterns;
+    patterns << "abc|xyz" << "(?:ab|c)d|e" << "a|b|\\d+" << "xy|x";
+
+    /* Cuantificadores opcionales y con cantidad.*/
+    patterns << "a{0}b" << "ab?c" << "ab{2}c" << "a{2,}c" << "x{1,3}y"
+             << "(?:ab){0}c" << "a{,2}" << "ab*c" << "b+c";
+
+    /* Aserciones antes de un literal.*/
+    patterns << "(?<=x)abc" << "(?<!y)abc" << "(?=ab)\\w+" << "\\babc"
+             << "^abc" << "(?<=a)b" << "(?!a)\\w";
+
+    /* Caracteres escapados dentro de clases.*/
+    patterns << "[\\]\\-a]x" << "[\\d\\\\]+" << "[^\\n]b" << "[\\x41-\\x43]c"
+             << "[a\\]]" << "[]a]b" << "[\\w]c";
+
+    /* Expresiones que reconocen texto vacío.*/
+    patterns << "a*" << "(?:ab)?c?" << "x*y?" << "(?:)" << "b*?c?"
+             << "(?:a|)b";
+
+    /* Otras construcciones.*/
+    patterns << ".b" << "\\x{4e2d}a" << "(a)\\1" << "(?i)ABC";
+
+    for (int i = 0; i < patterns.size(); ++i) {
+        for (int minimal = 0; minimal <= 1; ++minimal) {
+            checkSearch(patterns.at(i), minimal, subjects);
+            checkFirst(patterns.at(i), minimal, subjects);
+        }
+    }
+
+    /* Formatos que reconocen texto vacío, como el de la gramática standard.*/
+    checkScanner("^.*$", "^.*\\z", subjects);
+    checkScanner("x*", "x*", subjects);
+    checkScanner("(?=a)", "(?=a)", subjects);
+    checkScanner("b?", "b?", subjects);
+
+    /* Diccionarios con palabras solapadas, prefijos de otras y extremos que no
+    son caracteres de palabra.*/
+    QStringList dictionarySubjects;
+    dictionarySubjects << "" << "ushers" << "she hers" << "his,he" << "_he"
+                       << "abc ab" << "abcd" << "C++ C+" << "xC++ y"
+                       << "C++" << "x-yz x-y" << "a+b" << "(C)"
+                       << QString::fromUtf8("éhe he");
+    QList<QStringList> dictionaries;
+    dictionaries << (QStringList() << "he" << "she" << "his" << "hers");
+    dictionaries << (QStringList() << "ab" << "abc" << "abcd" << "b");
+    dictionaries << (QStringList() << "C++" << "C" << "C+" << "+" << "x-y"
+                     << "y");
+    for (int i = 0; i < dictionaries.size(); ++i) {
+        checkDictionary(dictionaries.at(i), dictionarySubjects);
+    }
+    checkCorrupted(dictionaries.at(0));
+
+    std::printf("%d comprobaciones fallidas\n", failures);
+    return failures == 0 ? 0 : 1;
+}
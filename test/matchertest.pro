@@ -0,0 +1,14 @@
+######################################################################
+# Comprobaciones del análisis de expresiones regulares de Matcher
+######################################################################
+
+TEMPLATE = app
+TARGET = matchertest
+CONFIG += console
+CONFIG -= app_bundle
+OBJECTS_DIR = build
+DESTDIR = bin
+
+include("../genericParser.pri")
+
+SOURCES += matchertest.cpp